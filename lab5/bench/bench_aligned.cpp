@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+// Фрагментация от выровненных выделений: очереди с элементами, выровненными по строке
+// кеша или странице, вперемешку с pmr-строками произвольной длины.
+// Сравнивается пул, где обрезок-выравнивание перед блоком остаётся свободным куском,
+// и пул, где короткие обрезки дописываются к предыдущему блоку (absorb_pad_below).
+// slivers — свободные куски короче самой короткой строки (32 байта): их уже никто не займёт.
+
+template <std::size_t Align>
+struct alignas(Align) Slot {
+    long value;
+};
+
+struct Result {
+    double mops = 0;
+    double fragmentation = 0;
+    std::size_t free_chunks = 0;
+    std::size_t slivers = 0;
+};
+
+template <std::size_t Align>
+Result run(bool absorb) {
+    StaticVectorBlocks::Options opts;
+    opts.absorb_pad_below = absorb ? 256 : 0;
+    StaticVectorBlocks pool(64u << 20, opts);
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::size_t> len(17, 300);
+    std::vector<std::unique_ptr<PmrQueue<Slot<Align>>>> queues;
+    std::vector<std::pmr::string> strings;
+
+    std::size_t ops = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int round = 0; round < 4000; ++round) {
+        strings.emplace_back(len(rng), 'x', &pool);
+        queues.push_back(std::make_unique<PmrQueue<Slot<Align>>>(1 + rng() % 6, &pool));
+        ops += 2;
+        if (strings.size() > 500) {
+            strings.erase(strings.begin() + rng() % strings.size());
+            ++ops;
+        }
+        if (queues.size() > 200) {
+            queues.erase(queues.begin() + rng() % queues.size());
+            ++ops;
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    StaticVectorBlocks::Stats s = pool.stats();
+    Result r;
+    r.mops = ops / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+    r.fragmentation = s.free_bytes ? 1.0 - static_cast<double>(s.largest_free) / s.free_bytes : 0.0;
+    r.free_chunks = s.free_chunks;
+    r.slivers = pool.free_chunks_below(32);
+    return r;
+}
+
+template <std::size_t Align>
+void report() {
+    for (bool absorb : {false, true}) {
+        Result r = run<Align>(absorb);
+        std::printf("%6zu %-8s %10.3f %7.1f%% %12zu %8zu\n", Align, absorb ? "absorb" : "keep", r.mops,
+                    100 * r.fragmentation, r.free_chunks, r.slivers);
+    }
+}
+
+int main() {
+    std::printf("%6s %-8s %10s %8s %12s %8s\n", "align", "pad", "Mops/s", "frag", "free chunks", "slivers");
+    report<64>();
+    report<4096>();
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buddy_res.hpp"
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+// Одна и та же нагрузка на оба ресурса: несколько очередей растут удвоением,
+// между ними создаются pmr-строки. Гоняем до исчерпания пула и смотрим,
+// сколько элементов поместилось и как фрагментирована память на пике.
+
+template <typename Resource>
+struct Peak {
+    std::size_t pushed = 0;
+    decltype(std::declval<Resource&>().stats()) stats;
+};
+
+template <typename Resource>
+Peak<Resource> fill_until_exhausted(Resource& pool) {
+    Peak<Resource> peak;
+    std::vector<PmrQueue<int>> queues;
+    std::vector<std::pmr::string> strings;
+    try {
+        for (int i = 0; i < 8; ++i) {
+            queues.emplace_back(4, &pool);
+        }
+        for (std::size_t step = 0;; ++step) {
+            queues[step % queues.size()].push(static_cast<int>(step));
+            ++peak.pushed;
+            if (step % 16 == 0) {
+                strings.emplace_back(40 + step % 200, 'x', &pool);
+            }
+        }
+    } catch (const std::bad_alloc&) {
+    }
+    peak.stats = pool.stats();
+    return peak;
+}
+
+int main() {
+    const std::size_t pool_size = 4u << 20;
+
+    {
+        StaticVectorBlocks pool(pool_size);
+        auto peak = fill_until_exhausted(pool);
+        std::printf("StaticVectorBlocks: pushed=%zu used=%zu free=%zu largest_free=%zu chunks=%zu\n",
+                    peak.pushed, peak.stats.used_bytes, peak.stats.free_bytes,
+                    peak.stats.largest_free, peak.stats.chunks);
+    }
+    {
+        BuddyBlocks pool(pool_size);
+        auto peak = fill_until_exhausted(pool);
+        std::printf("BuddyBlocks:        pushed=%zu used=%zu free=%zu largest_free=%zu internal_frag=%.1f%%\n",
+                    peak.pushed, peak.stats.used_bytes, peak.stats.free_bytes,
+                    peak.stats.largest_free, 100.0 * peak.stats.internal_fragmentation());
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "mem_res.hpp"
+
+// Пары освобождение + выделение в секунду: слияние при каждом освобождении
+// против отложенного слияния (Options::deferred_limit).
+// live блоков держатся постоянно; на каждом шаге случайный из них освобождается
+// и на его место выделяется новый блок. Размеры берутся из sizes.
+
+using Placement = StaticVectorBlocks::Placement;
+
+struct Result {
+    double mpairs = 0;
+    std::size_t chunks = 0;
+};
+
+Result churn(Placement policy, std::size_t deferred_limit, std::size_t live, const std::vector<std::size_t>& sizes) {
+    StaticVectorBlocks::Options opts;
+    opts.placement = policy;
+    opts.deferred_limit = deferred_limit;
+    StaticVectorBlocks pool(64u << 20, opts);
+
+    std::mt19937 rng(21);
+    std::vector<std::pair<void*, std::size_t>> blocks;
+    for (std::size_t i = 0; i < live; ++i) {
+        std::size_t bytes = sizes[rng() % sizes.size()];
+        blocks.emplace_back(pool.allocate(bytes), bytes);
+    }
+
+    const std::size_t pairs = 200000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < pairs; ++n) {
+        auto& [p, bytes] = blocks[rng() % live];
+        pool.deallocate(p, bytes);
+        bytes = sizes[rng() % sizes.size()];
+        p = pool.allocate(bytes);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    Result r;
+    r.mpairs = pairs / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+    r.chunks = pool.stats().chunks;
+    for (auto& [p, bytes] : blocks) pool.deallocate(p, bytes);
+    return r;
+}
+
+void report(const char* name, const std::vector<std::size_t>& sizes) {
+    for (Placement policy : {Placement::FirstFit, Placement::BestFit}) {
+        for (std::size_t live : {1000, 10000}) {
+            Result eager = churn(policy, 0, live, sizes);
+            Result lazy = churn(policy, 256, live, sizes);
+            std::printf("%-10s %-9s %6zu %10.3f %10.3f %7.2fx %8zu %8zu\n", name,
+                        policy == Placement::FirstFit ? "FirstFit" : "BestFit", live, eager.mpairs, lazy.mpairs,
+                        lazy.mpairs / eager.mpairs, eager.chunks, lazy.chunks);
+        }
+    }
+}
+
+int main() {
+    std::printf("%-10s %-9s %6s %10s %10s %8s %8s %8s\n", "sizes", "placement", "live", "eager", "deferred",
+                "speedup", "chunks", "chunks");
+    report("few", {32, 64, 96, 128});
+    std::vector<std::size_t> spread;
+    for (std::size_t b = 16; b <= 512; b += 16) spread.push_back(b);
+    report("16..512", spread);
+    report("mixed", {24, 40, 200, 1000, 3000});
+    return 0;
+}
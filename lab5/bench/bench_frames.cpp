@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+// Пакетная задача: на каждый запрос строится набор очередей и pmr-строк,
+// затем всё выбрасывается. Сравниваются обычное уничтожение объектов
+// и кадр StaticVectorBlocks (mark / release_to) без вызова деструкторов очередей.
+
+constexpr int kRequests = 2000;
+constexpr int kQueues = 64;
+constexpr int kStrings = 256;
+
+double run(bool frames) {
+    StaticVectorBlocks pool(64u << 20);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRequests; ++r) {
+        StaticVectorBlocks::Mark m{};
+        if (frames) {
+            m = pool.mark();
+        }
+        std::vector<PmrQueue<long>*> queues;
+        queues.reserve(kQueues);
+        for (int q = 0; q < kQueues; ++q) {
+            void* mem = pool.allocate(sizeof(PmrQueue<long>), alignof(PmrQueue<long>));
+            auto* queue = ::new (mem) PmrQueue<long>(4, &pool);
+            for (int i = 0; i < 8 + (q * 7 + r) % 40; ++i) queue->push(i);
+            queues.push_back(queue);
+        }
+        std::pmr::vector<std::pmr::string> strings(&pool);
+        for (int s = 0; s < kStrings; ++s) {
+            strings.emplace_back(24 + (s * 13 + r) % 200, 'x');
+        }
+
+        if (frames) {
+            // Строки лежат в кадре вместе с вектором; их память уходит целиком.
+            new (&strings) std::pmr::vector<std::pmr::string>(&pool);
+            pool.release_to(m);
+        } else {
+            strings.clear();
+            for (PmrQueue<long>* queue : queues) {
+                queue->~PmrQueue();
+                pool.deallocate(queue, sizeof(PmrQueue<long>), alignof(PmrQueue<long>));
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return kRequests / std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main() {
+    double eager = run(false);
+    double framed = run(true);
+    std::printf("%-22s %12s\n", "teardown", "requests/s");
+    std::printf("%-22s %12.0f\n", "destructors + free", eager);
+    std::printf("%-22s %12.0f\n", "mark / release_to", framed);
+    std::printf("speedup %.2fx\n", framed / eager);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+// Пропускная способность и фрагментация StaticVectorBlocks для каждой стратегии размещения.
+// Фрагментация: 1 - largest_free / free_bytes на пике нагрузки.
+
+using Placement = StaticVectorBlocks::Placement;
+
+struct Result {
+    double mops = 0;
+    double fragmentation = 0;
+    std::size_t chunks = 0;
+};
+
+Result snapshot(const StaticVectorBlocks& pool, std::size_t ops, double seconds) {
+    StaticVectorBlocks::Stats s = pool.stats();
+    Result r;
+    r.mops = ops / seconds / 1e6;
+    r.fragmentation = s.free_bytes ? 1.0 - static_cast<double>(s.largest_free) / s.free_bytes : 0.0;
+    r.chunks = s.chunks;
+    return r;
+}
+
+// Много очередей растут удвоением вперемешку и частично опустошаются.
+Result queue_growth(Placement policy) {
+    StaticVectorBlocks pool(32u << 20, policy);
+    std::vector<PmrQueue<long>> queues;
+    for (int i = 0; i < 64; ++i) queues.emplace_back(4, &pool);
+
+    std::size_t ops = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int round = 0; round < 20000; ++round) {
+        for (std::size_t q = 0; q < queues.size(); ++q) {
+            queues[q].push(round);
+            ++ops;
+            if ((round + q) % 3 == 0) {
+                queues[q].pop();
+                ++ops;
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return snapshot(pool, ops, std::chrono::duration<double>(t1 - t0).count());
+}
+
+// Набор pmr-строк случайной длины, которые постоянно заменяются.
+Result string_churn(Placement policy) {
+    StaticVectorBlocks pool(32u << 20, policy);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<std::size_t> len(16, 400);
+
+    std::vector<std::pmr::string> live;
+    for (int i = 0; i < 4000; ++i) live.emplace_back(len(rng), 'x', &pool);
+
+    const std::size_t ops = 50000;
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < ops; ++i) {
+        std::size_t idx = rng() % live.size();
+        live[idx] = std::pmr::string(len(rng), 'y', &pool);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return snapshot(pool, ops, std::chrono::duration<double>(t1 - t0).count());
+}
+
+int main() {
+    const std::pair<Placement, const char*> policies[] = {
+        {Placement::FirstFit, "FirstFit"},
+        {Placement::NextFit, "NextFit"},
+        {Placement::BestFit, "BestFit"},
+        {Placement::AddressOrdered, "AddressOrdered"},
+    };
+
+    std::printf("%-16s %-14s %10s %8s %8s\n", "policy", "workload", "Mops/s", "frag", "chunks");
+    for (auto [policy, name] : policies) {
+        Result q = queue_growth(policy);
+        std::printf("%-16s %-14s %10.3f %7.1f%% %8zu\n", name, "queue-growth", q.mops, 100 * q.fragmentation, q.chunks);
+        Result s = string_churn(policy);
+        std::printf("%-16s %-14s %10.3f %7.1f%% %8zu\n", name, "string-churn", s.mops, 100 * s.fragmentation, s.chunks);
+    }
+    return 0;
+}
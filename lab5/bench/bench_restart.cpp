@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include "file_res.hpp"
+#include "mem_res.hpp"
+#include "offset_queue.hpp"
+#include "queue.hpp"
+
+// Тёплый перезапуск: очередь из kItems сообщений нужно снова получить после
+// перезапуска процесса. Сравнивается повторное построение PmrQueue в памяти
+// (как при разборе снимка) и повторное открытие FileStaticVectorBlocks с OffsetQueue.
+
+struct Message {
+    std::uint64_t id;
+    std::uint64_t payload[3];
+};
+
+constexpr std::size_t kItems = 2'000'000;
+
+template <typename F>
+double seconds(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "lab5_bench_restart.pool").string();
+    std::filesystem::remove(path);
+    std::size_t pool_size = kItems * sizeof(Message) * 3;
+
+    double fill = seconds([&] {
+        FileStaticVectorBlocks pool(path.c_str(), pool_size);
+        auto q = OffsetQueue<Message>::at_root(pool, 0);
+        for (std::uint64_t i = 0; i < kItems; ++i) q.push({i, {i, i, i}});
+    });
+
+    std::uint64_t check = 0;
+    double rebuild = seconds([&] {
+        StaticVectorBlocks pool(pool_size);
+        PmrQueue<Message> q(16, &pool);
+        for (std::uint64_t i = 0; i < kItems; ++i) q.push({i, {i, i, i}});
+        check += q.back().id;
+    });
+
+    double reopen = seconds([&] {
+        FileStaticVectorBlocks pool(path.c_str(), pool_size);
+        auto q = OffsetQueue<Message>::at_root(pool, 0);
+        check += q.back().id + q.front().id;
+    });
+
+    std::printf("%-28s %10s\n", "queue of 2M messages", "ms");
+    std::printf("%-28s %10.2f\n", "first fill of the file", fill * 1e3);
+    std::printf("%-28s %10.2f\n", "rebuild in memory", rebuild * 1e3);
+    std::printf("%-28s %10.2f\n", "reopen file", reopen * 1e3);
+    std::printf("(check %llu)\n", static_cast<unsigned long long>(check));
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#include "offset_queue.hpp"
+#include "shared_res.hpp"
+
+#if LAB5_HAS_SHARED_POOL
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+// Передача kItems сообщений от дочернего процесса родителю: через pipe (каждое
+// сообщение копируется в ядро и обратно) и через OffsetQueue в общем пуле
+// SharedStaticVectorBlocks (потомок пишет прямо в память, которую читает родитель).
+
+struct Message {
+    std::uint64_t id;
+    std::uint64_t payload[7];
+};
+
+#if LAB5_HAS_SHARED_POOL
+
+constexpr std::size_t kItems = 1 << 20;  // кратно kBatch
+constexpr std::size_t kBatch = 256;
+
+template <typename F>
+double seconds(F&& f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <typename F>
+void child(F&& body) {
+    if (::fork() == 0) {
+        body();
+        ::_exit(0);
+    }
+}
+
+int main() {
+    std::uint64_t check = 0;
+
+    double piped = seconds([&] {
+        int fds[2];
+        if (::pipe(fds) != 0) return;
+        child([&] {
+            ::close(fds[0]);
+            Message batch[kBatch];
+            for (std::uint64_t i = 0; i < kItems; i += kBatch) {
+                for (std::size_t j = 0; j < kBatch; ++j) batch[j] = {i + j, {i, i, i, i, i, i, i}};
+                const char* p = reinterpret_cast<const char*>(batch);
+                for (std::size_t left = sizeof(batch); left;) {
+                    ssize_t n = ::write(fds[1], p, left);
+                    if (n <= 0) ::_exit(1);
+                    p += n;
+                    left -= static_cast<std::size_t>(n);
+                }
+            }
+        });
+        ::close(fds[1]);
+        Message m;
+        std::size_t got = 0;
+        char* p = reinterpret_cast<char*>(&m);
+        for (ssize_t n; (n = ::read(fds[0], p + got, sizeof(m) - got)) > 0;) {
+            got += static_cast<std::size_t>(n);
+            if (got == sizeof(m)) {
+                check += m.id;
+                got = 0;
+            }
+        }
+        ::close(fds[0]);
+        ::wait(nullptr);
+    });
+
+    double shared = seconds([&] {
+        SharedStaticVectorBlocks pool(kItems * sizeof(Message) * 3);
+        auto q = OffsetQueue<Message>::at_root(pool, 0);
+        child([&] {
+            for (std::uint64_t i = 0; i < kItems; i += kBatch) {
+                std::lock_guard<SharedStaticVectorBlocks> guard(pool);
+                for (std::size_t j = 0; j < kBatch; ++j) q.push({i + j, {i, i, i, i, i, i, i}});
+            }
+        });
+        ::wait(nullptr);
+        std::lock_guard<SharedStaticVectorBlocks> guard(pool);
+        for (; !q.empty(); q.pop()) check += q.front().id;
+    });
+
+    std::printf("%-28s %10s\n", "2^20 messages child->parent", "ms");
+    std::printf("%-28s %10.2f\n", "pipe (copy)", piped * 1e3);
+    std::printf("%-28s %10.2f\n", "shared pool + OffsetQueue", shared * 1e3);
+    std::printf("(check %llu)\n", static_cast<unsigned long long>(check));
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("shared pool is not supported on this platform\n");
+    return 0;
+}
+
+#endif
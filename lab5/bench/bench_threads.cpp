@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "lockfree_res.hpp"
+#include "mem_res.hpp"
+#include "sharded_res.hpp"
+#include "sync_res.hpp"
+
+// Масштабирование по числу потоков: StaticVectorBlocks под одним общим мьютексом
+// против SyncStaticVectorBlocks с потоковыми магазинами и ShardedBlocks с аренами по потокам.
+// Каждый поток держит окно живых блоков случайного размера и заменяет их по одному.
+// Вторая таблица — передача между потоками: каждый поток освобождает пачку, выделенную соседом;
+// блоки там одного размера, поэтому в ней есть и LockFreeFixedBlocks.
+
+class LockedBlocks: public std::pmr::memory_resource {
+public:
+    explicit LockedBlocks(std::size_t pool_size) : pool(pool_size) {}
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> guard(lock);
+        return pool.allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<std::mutex> guard(lock);
+        pool.deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::mutex lock;
+    StaticVectorBlocks pool;
+};
+
+constexpr std::size_t kOpsPerThread = 400000;
+constexpr std::size_t kWindow = 64;
+
+void churn(std::pmr::memory_resource* mr, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> len(16, 256);
+    std::vector<std::pair<void*, std::size_t>> live;
+    for (std::size_t i = 0; i < kWindow; ++i) {
+        std::size_t n = len(rng);
+        live.emplace_back(mr->allocate(n), n);
+    }
+    for (std::size_t i = 0; i < kOpsPerThread; ++i) {
+        auto& [p, n] = live[rng() % kWindow];
+        mr->deallocate(p, n);
+        n = len(rng);
+        p = mr->allocate(n);
+    }
+    for (auto [p, n] : live) mr->deallocate(p, n);
+}
+
+double run(std::pmr::memory_resource* mr, unsigned threads) {
+    std::vector<std::thread> pool;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back(churn, mr, t + 1);
+    }
+    for (auto& th : pool) th.join();
+    auto t1 = std::chrono::steady_clock::now();
+    // Каждая замена — одно освобождение и одно выделение.
+    return 2.0 * kOpsPerThread * threads / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+// Поток выделяет пачку, затем освобождает пачку соседа (как потребитель сообщений продюсера).
+constexpr std::size_t kBatch = 256;
+constexpr std::size_t kRounds = 1000;
+
+double handoff(std::pmr::memory_resource* mr, unsigned threads) {
+    std::vector<std::vector<void*>> batches(threads, std::vector<void*>(kBatch));
+    std::barrier sync(threads);
+    auto worker = [&](unsigned t) {
+        for (std::size_t r = 0; r < kRounds; ++r) {
+            for (void*& p : batches[t]) p = mr->allocate(64);
+            sync.arrive_and_wait();
+            for (void* p : batches[(t + 1) % threads]) mr->deallocate(p, 64);
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker, t);
+    for (auto& th : pool) th.join();
+    auto t1 = std::chrono::steady_clock::now();
+    return 2.0 * kBatch * kRounds * threads / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+int main() {
+    unsigned max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::printf("%8s %16s %16s %16s\n", "threads", "mutex Mops/s", "magazine Mops/s", "sharded Mops/s");
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        LockedBlocks locked(64u << 20);
+        SyncStaticVectorBlocks sync(64u << 20);
+        double a = run(&locked, t);
+        double b = run(&sync, t);
+        ShardedBlocks sharded(64u << 20, t);
+        double c = run(&sharded, t);
+        std::printf("%8u %16.2f %16.2f %16.2f\n", t, a, b, c);
+    }
+
+    std::printf("\ncross-thread free\n%8s %16s %16s %16s %16s\n", "threads", "mutex Mops/s", "magazine Mops/s",
+                "sharded Mops/s", "lock-free Mops/s");
+    for (unsigned t = 2; t <= max_threads; t *= 2) {
+        LockedBlocks locked(64u << 20);
+        SyncStaticVectorBlocks sync(64u << 20);
+        ShardedBlocks sharded(64u << 20, t);
+        LockFreeFixedBlocks fixed(64, kBatch * t);
+        std::printf("%8u %16.2f %16.2f %16.2f %16.2f\n", t, handoff(&locked, t), handoff(&sync, t),
+                    handoff(&sharded, t), handoff(&fixed, t));
+    }
+    return 0;
+}
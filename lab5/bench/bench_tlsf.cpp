@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "mem_res.hpp"
+#include "tlsf_res.hpp"
+
+// Задержка пары free+allocate при растущем числе живых блоков.
+// Для TLSF она должна оставаться плоской, для first-fit — расти вместе с таблицей.
+
+struct Live {
+    void* p;
+    std::size_t n;
+};
+
+template <typename Resource>
+void run(const char* name, std::size_t live_count, std::size_t ops) {
+    Resource pool(64u << 20);
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> size_dist(16, 512);
+
+    std::vector<Live> live;
+    live.reserve(live_count);
+    for (std::size_t i = 0; i < live_count; ++i) {
+        std::size_t n = size_dist(rng);
+        live.push_back({pool.allocate(n), n});
+    }
+
+    std::vector<double> lat;
+    lat.reserve(ops);
+    for (std::size_t i = 0; i < ops; ++i) {
+        std::size_t idx = rng() % live.size();
+        std::size_t n = size_dist(rng);
+
+        auto t0 = std::chrono::steady_clock::now();
+        pool.deallocate(live[idx].p, live[idx].n);
+        live[idx] = {pool.allocate(n), n};
+        auto t1 = std::chrono::steady_clock::now();
+
+        lat.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    for (auto& l : live) pool.deallocate(l.p, l.n);
+
+    std::sort(lat.begin(), lat.end());
+    double sum = 0;
+    for (double v : lat) sum += v;
+    auto pct = [&](double q) { return lat[static_cast<std::size_t>(q * (lat.size() - 1))]; };
+    std::printf("%-20s live=%-7zu mean=%9.1f ns  p99=%9.1f ns  p99.9=%9.1f ns\n",
+                name, live_count, sum / lat.size(), pct(0.99), pct(0.999));
+}
+
+int main() {
+    const std::size_t ops = 20000;
+    for (std::size_t live : {1000u, 4000u, 16000u}) {
+        run<StaticVectorBlocks>("StaticVectorBlocks", live, ops);
+        run<TlsfBlocks>("TlsfBlocks", live, ops);
+    }
+    return 0;
+}
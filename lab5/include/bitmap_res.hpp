@@ -0,0 +1,180 @@
+#pragma once
+#include <memory_resource>
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Пул из гранул фиксированного размера, занятость которых хранится битовой картой:
+// один бит на гранулу вместо записи Chunk на каждый блок.
+// Поиск свободного участка идёт по словам: полностью занятые (или свободные) слова
+// пропускаются целиком, границы участка находятся через countr_zero (tzcnt).
+// При сборке с AVX2 однородные участки карты пропускаются по 256 бит за раз.
+// Освобождение — сброс битов; слияние соседей происходит само собой.
+// Число гранул блока вычисляется из bytes, переданного в deallocate.
+class BitmapBlocks: public std::pmr::memory_resource {
+public:
+    explicit BitmapBlocks(std::size_t pool_size, std::size_t granule = 16)
+        : pool_size(pool_size), granule(granule), granules(pool_size / granule) {
+        assert(std::has_single_bit(granule) && granule <= kBaseAlign && "гранула должна быть степенью двойки");
+        pool = ::operator new(pool_size, std::align_val_t{kBaseAlign});
+
+        // Биты за концом пула помечены занятыми, чтобы поиск не выходил за границу.
+        bits.assign((granules + 63) / 64, 0);
+        if (granules % 64) {
+            bits.back() = ~std::uint64_t(0) << (granules % 64);
+        }
+    }
+
+    ~BitmapBlocks() override {
+        ::operator delete(pool, std::align_val_t{kBaseAlign});
+    }
+
+    BitmapBlocks(const BitmapBlocks&) = delete;
+    BitmapBlocks& operator=(const BitmapBlocks&) = delete;
+
+    std::size_t used_granules() const noexcept { return used; }
+    std::size_t granule_size() const noexcept { return granule; }
+
+private:
+    static constexpr std::size_t kBaseAlign = 4096;
+    static constexpr std::uint64_t kFull = ~std::uint64_t(0);
+
+    std::byte* base() const { return static_cast<std::byte*>(pool); }
+
+    // Первое слово, начиная с w, в котором есть хотя бы один нулевой (свободный) бит.
+    std::size_t skip_full_words(std::size_t w) const {
+#if defined(__AVX2__)
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        for (; w + 4 <= bits.size(); w += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits.data() + w));
+            if (!_mm256_testc_si256(v, ones)) break;
+        }
+#endif
+        while (w < bits.size() && bits[w] == kFull) ++w;
+        return w;
+    }
+
+    // Первое слово, начиная с w, в котором есть хотя бы один единичный (занятый) бит.
+    std::size_t skip_empty_words(std::size_t w) const {
+#if defined(__AVX2__)
+        for (; w + 4 <= bits.size(); w += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits.data() + w));
+            if (!_mm256_testz_si256(v, v)) break;
+        }
+#endif
+        while (w < bits.size() && bits[w] == 0) ++w;
+        return w;
+    }
+
+    std::size_t next_free(std::size_t i) const {
+        std::size_t w = i / 64;
+        if (w >= bits.size()) return granules;
+        std::uint64_t word = bits[w] | ((std::uint64_t(1) << (i % 64)) - 1);
+        if (word == kFull) {
+            w = skip_full_words(w + 1);
+            if (w >= bits.size()) return granules;
+            word = bits[w];
+        }
+        return w * 64 + std::countr_zero(~word);
+    }
+
+    std::size_t next_used(std::size_t i) const {
+        std::size_t w = i / 64;
+        if (w >= bits.size()) return granules;
+        std::uint64_t word = bits[w] & ~((std::uint64_t(1) << (i % 64)) - 1);
+        if (word == 0) {
+            w = skip_empty_words(w + 1);
+            if (w >= bits.size()) return granules;
+            word = bits[w];
+        }
+        std::size_t pos = w * 64 + std::countr_zero(word);
+        return pos < granules ? pos : granules;
+    }
+
+    void set_range(std::size_t start, std::size_t n, bool value) {
+        while (n > 0) {
+            std::size_t w = start / 64;
+            std::size_t shift = start % 64;
+            std::size_t take = 64 - shift < n ? 64 - shift : n;
+            std::uint64_t mask = (take == 64 ? kFull : ((std::uint64_t(1) << take) - 1)) << shift;
+            assert(value ? (bits[w] & mask) == 0 : (bits[w] & mask) == mask);
+            if (value) {
+                bits[w] |= mask;
+            } else {
+                bits[w] &= ~mask;
+            }
+            start += take;
+            n -= take;
+        }
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment > kBaseAlign) {
+            throw std::bad_alloc();
+        }
+
+        std::size_t n = (bytes + granule - 1) / granule;
+        std::size_t step = alignment > granule ? alignment / granule : 1;
+
+        std::size_t i = next_free(hint);
+        while (i < granules) {
+            std::size_t start = (i + step - 1) / step * step;
+            std::size_t end = start < granules ? next_used(start) : granules;
+            if (start < end && end - start >= n) {
+                set_range(start, n, true);
+                used += n;
+                if (start == hint) {
+                    hint = start + n;
+                }
+                return base() + start * granule;
+            }
+            i = next_free(end > start ? end : start);
+        }
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+        if (!p) {
+            return;
+        }
+        if (bytes == 0) {
+            bytes = 1;
+        }
+
+        std::byte* ptr = static_cast<std::byte*>(p);
+        if (ptr < base() || ptr >= base() + granules * granule) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+
+        std::size_t start = static_cast<std::size_t>(ptr - base()) / granule;
+        std::size_t n = (bytes + granule - 1) / granule;
+        set_range(start, n, false);
+        used -= n;
+        if (start < hint) {
+            hint = start;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void* pool = nullptr;
+    std::size_t pool_size = 0;
+    std::size_t granule;
+    std::size_t granules;
+    std::size_t used = 0;
+    std::size_t hint = 0;  // ниже hint свободных гранул нет
+    std::vector<std::uint64_t> bits;
+};
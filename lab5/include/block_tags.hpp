@@ -0,0 +1,126 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Общая часть пулов с граничными тегами (BoundaryTagBlocks, TlsfBlocks): раскладка
+// блока, разбиение свободного блока при выделении и слияние с соседями при
+// освобождении. Списки свободных блоков у каждого пула свои, поэтому разбиение и
+// слияние получают их операции параметрами.
+//
+// Раскладка блока (все блоки выровнены на kGranule):
+//   [size|flags : 8][back : 8][полезные данные ...][size : 8 — только у свободных]
+// back — слово прямо перед полезными данными, хранит смещение до начала блока.
+// У свободного блока в полезной части лежат указатели next/prev списка свободных.
+// Пул заканчивается эпилогом — занятым блоком нулевого размера.
+namespace block_tags {
+
+constexpr std::size_t kGranule = alignof(std::max_align_t);
+constexpr std::size_t kHeader = 2 * sizeof(std::size_t);
+constexpr std::size_t kUsed = 1;
+constexpr std::size_t kPrevUsed = 2;
+constexpr std::size_t kFlags = kUsed | kPrevUsed;
+
+struct FreeLinks {
+    std::byte* next;
+    std::byte* prev;
+};
+
+// Свободный блок должен вместить заголовок, ссылки списка и футер.
+constexpr std::size_t kMinBlock = (kHeader + sizeof(FreeLinks) + sizeof(std::size_t) + kGranule - 1) / kGranule * kGranule;
+
+inline std::uintptr_t align_up(std::uintptr_t p, std::size_t a) {
+    return (p + (a - 1)) & ~(a - 1);
+}
+
+inline std::size_t& header(std::byte* b) { return *reinterpret_cast<std::size_t*>(b); }
+inline std::size_t block_size(std::byte* b) { return header(b) & ~kFlags; }
+inline bool is_used(std::byte* b) { return header(b) & kUsed; }
+inline bool prev_used(std::byte* b) { return header(b) & kPrevUsed; }
+inline FreeLinks& links(std::byte* b) { return *reinterpret_cast<FreeLinks*>(b + kHeader); }
+
+inline void set_header(std::byte* b, std::size_t sz, bool used, bool prev) {
+    header(b) = sz | (used ? kUsed : 0) | (prev ? kPrevUsed : 0);
+}
+inline void set_footer(std::byte* b, std::size_t sz) {
+    *reinterpret_cast<std::size_t*>(b + sz - sizeof(std::size_t)) = sz;
+}
+inline void set_prev_used(std::byte* b, bool prev) {
+    header(b) = (header(b) & ~kPrevUsed) | (prev ? kPrevUsed : 0);
+}
+
+// Разметить пул с начала base: свободный блок first_sz байт и эпилог за ним.
+inline std::byte* format(std::byte* base, std::size_t first_sz) {
+    set_header(base, first_sz, false, true);
+    set_footer(base, first_sz);
+    set_header(base + first_sz, 0, true, false);
+    return base;
+}
+
+// Размер блока под bytes байт с выравниванием alignment (не меньше kGranule);
+// для сверхвыравнивания берётся запас, чтобы данные можно было сдвинуть внутри блока.
+// 0, если размер не представим.
+inline std::size_t block_need(std::size_t bytes, std::size_t alignment) {
+    std::size_t need = kHeader + bytes + (alignment - kGranule);
+    if (need < bytes) {
+        return 0;
+    }
+    need = align_up(need, kGranule);
+    return need < kMinBlock ? kMinBlock : need;
+}
+
+// Занять свободный блок b, уже вынутый из списков, под need байт. Остаток не меньше
+// kMinBlock отделяется свободным блоком и передаётся insert_free.
+// Возвращает выровненный на alignment указатель на данные.
+template <typename InsertFree>
+void* take(std::byte* b, std::size_t need, std::size_t alignment, InsertFree insert_free) {
+    std::size_t sz = block_size(b);
+    std::size_t rest = sz - need;
+    if (rest >= kMinBlock) {
+        std::byte* tail = b + need;
+        set_header(tail, rest, false, true);
+        set_footer(tail, rest);
+        insert_free(tail);
+        sz = need;
+    } else {
+        set_prev_used(b + sz, true);
+    }
+    set_header(b, sz, true, prev_used(b));
+
+    std::uintptr_t data = align_up(reinterpret_cast<std::uintptr_t>(b + kHeader), alignment);
+    reinterpret_cast<std::size_t*>(data)[-1] = static_cast<std::size_t>(data - reinterpret_cast<std::uintptr_t>(b));
+    return reinterpret_cast<void*>(data);
+}
+
+// Блок, которому принадлежат данные p.
+inline std::byte* block_of(void* p) {
+    auto* data = static_cast<std::byte*>(p);
+    return data - reinterpret_cast<std::size_t*>(data)[-1];
+}
+
+// Освободить занятый блок b, слив его со свободными соседями (remove_free вынимает
+// их из списков). Возвращает получившийся свободный блок; в списки его кладёт вызывающий.
+template <typename RemoveFree>
+std::byte* release(std::byte* b, RemoveFree remove_free) {
+    std::size_t sz = block_size(b);
+    bool prev = prev_used(b);
+
+    std::byte* next = b + sz;
+    if (!is_used(next)) {
+        remove_free(next);
+        sz += block_size(next);
+    }
+    if (!prev) {
+        std::size_t prev_sz = *reinterpret_cast<std::size_t*>(b - sizeof(std::size_t));
+        b -= prev_sz;
+        remove_free(b);
+        sz += prev_sz;
+        prev = prev_used(b);
+    }
+
+    set_header(b, sz, false, prev);
+    set_footer(b, sz);
+    set_prev_used(b + sz, false);
+    return b;
+}
+
+}  // namespace block_tags
@@ -0,0 +1,108 @@
+#pragma once
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#include "block_tags.hpp"
+
+// Пул с граничными тегами: заголовок и футер блока лежат в самом пуле,
+// поэтому освобождение и слияние с соседями выполняются за O(1),
+// а отдельной таблицы блоков на глобальной куче нет.
+// Раскладка блока и разбиение/слияние — в block_tags.hpp; свободные блоки
+// здесь лежат в одном двусвязном списке.
+class BoundaryTagBlocks: public std::pmr::memory_resource {
+public:
+    explicit BoundaryTagBlocks(std::size_t pool_size): pool_size(pool_size) {
+        pool = ::operator new(pool_size);
+
+        std::size_t usable = (pool_size / kGranule) * kGranule;
+        if (usable < kMinBlock + kGranule) {
+            return;
+        }
+        // Последние kGranule байт — эпилог.
+        push_free(block_tags::format(base(), usable - kGranule));
+    }
+
+    ~BoundaryTagBlocks() override {
+        ::operator delete(pool);
+    }
+
+    BoundaryTagBlocks(const BoundaryTagBlocks&) = delete;
+    BoundaryTagBlocks& operator=(const BoundaryTagBlocks&) = delete;
+
+private:
+    using FreeLinks = block_tags::FreeLinks;
+    static constexpr std::size_t kGranule = block_tags::kGranule;
+    static constexpr std::size_t kHeader = block_tags::kHeader;
+    static constexpr std::size_t kMinBlock = block_tags::kMinBlock;
+
+    std::byte* base() const { return static_cast<std::byte*>(pool); }
+
+    static FreeLinks& links(std::byte* b) { return block_tags::links(b); }
+
+    void push_free(std::byte* b) {
+        links(b) = {free_head, nullptr};
+        if (free_head) {
+            links(free_head).prev = b;
+        }
+        free_head = b;
+    }
+
+    void unlink_free(std::byte* b) {
+        FreeLinks& l = links(b);
+        if (l.prev) {
+            links(l.prev).next = l.next;
+        } else {
+            free_head = l.next;
+        }
+        if (l.next) {
+            links(l.next).prev = l.prev;
+        }
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment < kGranule) {
+            alignment = kGranule;
+        }
+        std::size_t need = block_tags::block_need(bytes, alignment);
+        if (need == 0) {
+            throw std::bad_alloc();
+        }
+
+        for (std::byte* b = free_head; b; b = links(b).next) {
+            if (block_tags::block_size(b) < need) continue;
+
+            unlink_free(b);
+            return block_tags::take(b, need, alignment, [this](std::byte* tail) { push_free(tail); });
+        }
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override {
+        if (!p) {
+            return;
+        }
+
+        std::byte* data = static_cast<std::byte*>(p);
+        if (data < base() + kHeader || data >= base() + pool_size) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+        std::byte* b = block_tags::block_of(p);
+        assert(block_tags::is_used(b) && "повторное освобождение блока");
+        push_free(block_tags::release(b, [this](std::byte* n) { unlink_free(n); }));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void* pool = nullptr;
+    std::size_t pool_size = 0;
+    std::byte* free_head = nullptr;
+};
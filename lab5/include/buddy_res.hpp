@@ -0,0 +1,204 @@
+#pragma once
+#include <memory_resource>
+#include <bit>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+// Бинарный buddy-аллокатор. Блок порядка k имеет размер 2^k и смещение,
+// кратное 2^k, поэтому его "близнец" находится по off ^ 2^k.
+// Свободные блоки каждого порядка лежат в двусвязном списке внутри самих блоков,
+// а битовая карта порядка отвечает на вопрос "свободен ли близнец" за O(1).
+// Деление и слияние — O(log n). Порядок освобождаемого блока вычисляется
+// из bytes/alignment, которые memory_resource обязан передать те же, что при выделении.
+class BuddyBlocks: public std::pmr::memory_resource {
+public:
+    struct Stats {
+        std::size_t requested_bytes = 0;  // сумма запрошенных bytes у живых блоков
+        std::size_t used_bytes = 0;       // сумма размеров выданных блоков
+        std::size_t free_bytes = 0;
+        std::size_t largest_free = 0;
+        std::size_t metadata_bytes = 0;   // битовые карты порядков на глобальной куче
+
+        double internal_fragmentation() const {
+            return used_bytes ? 1.0 - static_cast<double>(requested_bytes) / used_bytes : 0.0;
+        }
+    };
+
+    explicit BuddyBlocks(std::size_t pool_size): pool_size(pool_size) {
+        pool = ::operator new(pool_size, std::align_val_t{kBaseAlign});
+
+        std::size_t usable = pool_size & ~((std::size_t(1) << kMinOrder) - 1);
+        // Порядки меньше kMinOrder не выдаются: карт для них нет.
+        for (unsigned k = kMinOrder; k <= kMaxOrder; ++k) {
+            bits_of(k).assign(((usable >> k) + 63) / 64, 0);
+        }
+
+        // Пул произвольного размера раскладываем на блоки по двоичным разрядам:
+        // каждый следующий блок меньше и выровнен на свой размер.
+        std::size_t off = 0;
+        for (unsigned k = kMaxOrder + 1; k-- > kMinOrder;) {
+            if (usable & (std::size_t(1) << k)) {
+                push_free(off, k);
+                off += std::size_t(1) << k;
+            }
+        }
+        st.free_bytes = usable;
+    }
+
+    ~BuddyBlocks() override {
+        ::operator delete(pool, std::align_val_t{kBaseAlign});
+    }
+
+    BuddyBlocks(const BuddyBlocks&) = delete;
+    BuddyBlocks& operator=(const BuddyBlocks&) = delete;
+
+    Stats stats() const {
+        Stats s = st;
+        s.largest_free = nonempty ? std::size_t(1) << (63 - std::countl_zero(nonempty)) : 0;
+        for (const std::vector<std::uint64_t>& bits : free_bits) {
+            s.metadata_bytes += bits.capacity() * sizeof(std::uint64_t);
+        }
+        return s;
+    }
+
+private:
+    static constexpr unsigned kMinOrder = 4;
+    static constexpr unsigned kMaxOrder = 47;
+    static constexpr std::size_t kBaseAlign = 4096;
+
+    struct FreeLinks {
+        std::byte* next;
+        std::byte* prev;
+    };
+    static_assert(sizeof(FreeLinks) <= (std::size_t(1) << kMinOrder));
+
+    std::byte* base() const { return static_cast<std::byte*>(pool); }
+    FreeLinks& links(std::size_t off) const { return *reinterpret_cast<FreeLinks*>(base() + off); }
+    std::vector<std::uint64_t>& bits_of(unsigned k) { return free_bits[k - kMinOrder]; }
+    const std::vector<std::uint64_t>& bits_of(unsigned k) const { return free_bits[k - kMinOrder]; }
+
+    static unsigned order_for(std::size_t bytes, std::size_t alignment) {
+        std::size_t need = bytes > alignment ? bytes : alignment;
+        unsigned k = static_cast<unsigned>(std::bit_width(need - 1));
+        return k < kMinOrder ? kMinOrder : k;
+    }
+
+    bool is_free(std::size_t off, unsigned k) const {
+        std::size_t idx = off >> k;
+        const std::vector<std::uint64_t>& bits = bits_of(k);
+        return idx / 64 < bits.size() && (bits[idx / 64] >> (idx % 64)) & 1;
+    }
+
+    void set_free_bit(std::size_t off, unsigned k, bool value) {
+        std::size_t idx = off >> k;
+        std::uint64_t mask = std::uint64_t(1) << (idx % 64);
+        if (value) {
+            bits_of(k)[idx / 64] |= mask;
+        } else {
+            bits_of(k)[idx / 64] &= ~mask;
+        }
+    }
+
+    void push_free(std::size_t off, unsigned k) {
+        std::byte* b = base() + off;
+        links(off) = {heads[k], nullptr};
+        if (heads[k]) {
+            reinterpret_cast<FreeLinks*>(heads[k])->prev = b;
+        }
+        heads[k] = b;
+        nonempty |= std::uint64_t(1) << k;
+        set_free_bit(off, k, true);
+    }
+
+    void remove_free(std::size_t off, unsigned k) {
+        FreeLinks& l = links(off);
+        if (l.prev) {
+            reinterpret_cast<FreeLinks*>(l.prev)->next = l.next;
+        } else {
+            heads[k] = l.next;
+        }
+        if (l.next) {
+            reinterpret_cast<FreeLinks*>(l.next)->prev = l.prev;
+        }
+        if (!heads[k]) {
+            nonempty &= ~(std::uint64_t(1) << k);
+        }
+        set_free_bit(off, k, false);
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment > kBaseAlign || bytes > (std::size_t(1) << kMaxOrder)) {
+            throw std::bad_alloc();
+        }
+
+        unsigned k = order_for(bytes, alignment);
+        std::uint64_t candidates = nonempty & (~std::uint64_t(0) << k);
+        if (!candidates) {
+            throw std::bad_alloc();
+        }
+        unsigned j = static_cast<unsigned>(std::countr_zero(candidates));
+        std::size_t off = static_cast<std::size_t>(heads[j] - base());
+        remove_free(off, j);
+
+        while (j > k) {
+            --j;
+            push_free(off + (std::size_t(1) << j), j);
+        }
+
+        st.requested_bytes += bytes;
+        st.used_bytes += std::size_t(1) << k;
+        st.free_bytes -= std::size_t(1) << k;
+        return base() + off;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p) {
+            return;
+        }
+        if (bytes == 0) {
+            bytes = 1;
+        }
+
+        std::byte* ptr = static_cast<std::byte*>(p);
+        if (ptr < base() || ptr >= base() + pool_size) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+
+        unsigned k = order_for(bytes, alignment);
+        std::size_t off = static_cast<std::size_t>(ptr - base());
+        assert(off % (std::size_t(1) << k) == 0 && "размер не совпадает с выделенным");
+
+        st.requested_bytes -= bytes;
+        st.used_bytes -= std::size_t(1) << k;
+        st.free_bytes += std::size_t(1) << k;
+
+        while (k < kMaxOrder) {
+            std::size_t buddy = off ^ (std::size_t(1) << k);
+            if (!is_free(buddy, k)) {
+                break;
+            }
+            remove_free(buddy, k);
+            off &= ~(std::size_t(1) << k);
+            ++k;
+        }
+        push_free(off, k);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void* pool = nullptr;
+    std::size_t pool_size = 0;
+    std::byte* heads[kMaxOrder + 1] = {};
+    std::uint64_t nonempty = 0;
+    std::vector<std::uint64_t> free_bits[kMaxOrder - kMinOrder + 1];
+    Stats st;
+};
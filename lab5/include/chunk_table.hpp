@@ -0,0 +1,210 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Таблица блоков пула, упорядоченная по смещению, в виде структуры массивов:
+// off[] и sz[] лежат отдельно, признак "свободен" — битовый набор.
+// Поиску первого подходящего блока нужны только sz и free, поэтому он читает
+// плотный массив размеров и по 64 флага за раз, не затрагивая off.
+class ChunkTable {
+public:
+    struct Chunk {
+        std::size_t off;
+        std::size_t sz;
+        bool free;
+    };
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    ChunkTable() = default;
+    explicit ChunkTable(std::pmr::memory_resource* mr) : off_(mr), sz_(mr), free_(mr) {}
+
+    std::size_t size() const noexcept { return off_.size(); }
+
+    void reserve(std::size_t n) {
+        off_.reserve(n);
+        sz_.reserve(n);
+        free_.reserve((n + 63) / 64);
+    }
+
+    void clear() noexcept {
+        off_.clear();
+        sz_.clear();
+        free_.clear();
+    }
+
+    Chunk operator[](std::size_t i) const { return {off_[i], sz_[i], is_free(i)}; }
+
+    std::size_t off(std::size_t i) const { return off_[i]; }
+    std::size_t sz(std::size_t i) const { return sz_[i]; }
+    bool is_free(std::size_t i) const { return (free_[i / 64] >> (i % 64)) & 1; }
+
+    void set(std::size_t i, const Chunk& c) {
+        off_[i] = c.off;
+        sz_[i] = c.sz;
+        set_free(i, c.free);
+    }
+    void set_sz(std::size_t i, std::size_t sz) { sz_[i] = sz; }
+    void set_free(std::size_t i, bool value) {
+        std::uint64_t mask = std::uint64_t(1) << (i % 64);
+        if (value) {
+            free_[i / 64] |= mask;
+        } else {
+            free_[i / 64] &= ~mask;
+        }
+    }
+
+    void push_back(const Chunk& c) {
+        off_.push_back(c.off);
+        sz_.push_back(c.sz);
+        if (free_.size() * 64 < off_.size()) {
+            free_.push_back(0);
+        }
+        set_free(off_.size() - 1, c.free);
+    }
+
+    // Вставка n (не больше 63) записей перед позицией i.
+    void insert(std::size_t i, const Chunk* items, std::size_t n) {
+        if (n == 0) return;
+        assert(n < 64);
+        std::size_t old = size();
+        off_.resize(old + n);
+        sz_.resize(old + n);
+        free_.resize((old + n + 63) / 64, 0);
+
+        std::copy_backward(off_.begin() + i, off_.begin() + old, off_.end());
+        std::copy_backward(sz_.begin() + i, sz_.begin() + old, sz_.end());
+        shift_bits_up(i, n);
+
+        for (std::size_t k = 0; k < n; ++k) {
+            set(i + k, items[k]);
+        }
+    }
+
+    void erase(std::size_t i) {
+        off_.erase(off_.begin() + i);
+        sz_.erase(sz_.begin() + i);
+        shift_bits_down(i);
+        free_.resize((size() + 63) / 64);
+    }
+
+    // Слить смежные по адресу свободные записи в диапазоне [from, to) одним проходом;
+    // хвост таблицы за to сдвигается один раз. Возвращает новый конец диапазона.
+    std::size_t coalesce(std::size_t from, std::size_t to) {
+        std::size_t w = from;
+        for (std::size_t r = from; r < to; ++r) {
+            if (w > from && is_free(w - 1) && is_free(r) && off_[w - 1] + sz_[w - 1] == off_[r]) {
+                sz_[w - 1] += sz_[r];
+                continue;
+            }
+            if (w != r) {
+                set(w, (*this)[r]);
+            }
+            ++w;
+        }
+        std::size_t end = w;
+        if (w != to) {
+            for (std::size_t r = to; r < size(); ++r, ++w) {
+                set(w, (*this)[r]);
+            }
+            off_.resize(w);
+            sz_.resize(w);
+            free_.resize((w + 63) / 64);
+        }
+        return end;
+    }
+
+    // Позиция записи с данным смещением или место, куда её пришлось бы вставить.
+    std::size_t lower_bound(std::size_t off) const {
+        return static_cast<std::size_t>(std::lower_bound(off_.begin(), off_.end(), off) - off_.begin());
+    }
+
+    // Первый свободный блок с позиции from, у которого sz >= min_sz и pred(i) истинно.
+    // Размеры сравниваются пачками по 64 (векторно), флаги свободы берутся целым словом.
+    template <typename Pred>
+    std::size_t find_free(std::size_t from, std::size_t min_sz, Pred pred) const {
+        for (std::size_t w = from / 64; w < free_.size(); ++w) {
+            std::uint64_t cand = free_[w];
+            if (w == from / 64) {
+                cand &= ~std::uint64_t(0) << (from % 64);
+            }
+            if (!cand) continue;
+
+            cand &= size_mask(w * 64, min_sz);
+            while (cand) {
+                std::size_t i = w * 64 + static_cast<std::size_t>(std::countr_zero(cand));
+                if (pred(i)) return i;
+                cand &= cand - 1;
+            }
+        }
+        return npos;
+    }
+
+private:
+    // Бит j маски установлен, если sz[base + j] >= min_sz.
+    std::uint64_t size_mask(std::size_t base, std::size_t min_sz) const {
+        std::size_t n = std::min<std::size_t>(64, size() - base);
+        const std::size_t* s = sz_.data() + base;
+        std::uint64_t mask = 0;
+        std::size_t j = 0;
+#if defined(__AVX2__)
+        // Размеры меньше 2^63, поэтому знаковое сравнение годится.
+        const __m256i lim = _mm256_set1_epi64x(static_cast<long long>(min_sz) - 1);
+        for (; j + 4 <= n; j += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + j));
+            int m = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, lim)));
+            mask |= static_cast<std::uint64_t>(m) << j;
+        }
+#endif
+        for (; j < n; ++j) {
+            mask |= static_cast<std::uint64_t>(s[j] >= min_sz) << j;
+        }
+        return mask;
+    }
+
+    // Биты [i, size - n) сдвигаются на n позиций вверх; биты ниже i не меняются.
+    void shift_bits_up(std::size_t i, std::size_t n) {
+        std::size_t first = i / 64;
+        for (std::size_t w = free_.size(); w-- > first;) {
+            std::uint64_t cur = free_[w];
+            std::uint64_t shifted = cur << n;
+            if (w > first) {
+                shifted |= free_[w - 1] >> (64 - n);
+            } else {
+                std::uint64_t low = (std::uint64_t(1) << (i % 64)) - 1;
+                shifted = (cur & low) | (shifted & ~low);
+            }
+            free_[w] = shifted;
+        }
+    }
+
+    // Бит i удаляется, биты выше сдвигаются на одну позицию вниз.
+    void shift_bits_down(std::size_t i) {
+        std::size_t first = i / 64;
+        for (std::size_t w = first; w < free_.size(); ++w) {
+            std::uint64_t cur = free_[w];
+            std::uint64_t shifted = cur >> 1;
+            if (w + 1 < free_.size()) {
+                shifted |= free_[w + 1] << 63;
+            }
+            if (w == first) {
+                std::uint64_t low = (std::uint64_t(1) << (i % 64)) - 1;
+                shifted = (cur & low) | (shifted & ~low);
+            }
+            free_[w] = shifted;
+        }
+    }
+
+    std::pmr::vector<std::size_t> off_;
+    std::pmr::vector<std::size_t> sz_;
+    std::pmr::vector<std::uint64_t> free_;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <cstddef>
+
+#include "os_map.hpp"
+#include "region_res.hpp"
+
+// Пул в файле, отображённом через mmap(MAP_SHARED). Заголовок и таблица блоков хранятся
+// в начале файла (см. RegionBlocks), поэтому после перезапуска процесса пул открывается
+// с тем же содержимым без какого-либо разбора данных: объекты находятся через корни,
+// а внутри блоков хранятся смещения (OffsetQueue), а не указатели.
+// Изменения таблицы не атомарны: гарантируется только состояние на момент sync()
+// или закрытия пула, но не после аварии посреди выделения.
+class FileStaticVectorBlocks: public RegionBlocks {
+public:
+    // Открыть пул в файле path. Пустой или новый файл размечается заново на size байт
+    // (вместе с заголовком) с таблицей на table_capacity записей. Уже размеченный файл
+    // подхватывается со своими размерами, а size и table_capacity не используются.
+    // Непустой файл без заголовка пула не трогается: std::runtime_error.
+    FileStaticVectorBlocks(const char* path, std::size_t size, std::size_t table_capacity = 4096)
+        : file(osmem::map_file(path, size)) {
+        auto* mem = static_cast<std::byte*>(file.map.addr);
+        if (file.created) {
+            try {
+                format(mem, file.map.len, table_capacity);
+            } catch (...) {
+                osmem::unmap_file(file);
+                throw;
+            }
+        } else if (!attach(mem, file.map.len)) {
+            osmem::unmap_file(file);
+            throw std::runtime_error(std::string(path) + ": файл не является пулом");
+        }
+    }
+
+    ~FileStaticVectorBlocks() override {
+        osmem::sync(file.map);
+        osmem::unmap_file(file);
+    }
+
+    // Дождаться записи всех изменений в файл.
+    void sync() { osmem::sync(file.map); }
+
+private:
+    osmem::FileMapping file;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include <memory_resource>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#include "os_map.hpp"
+
+// Ресурс блоков одного размера без блокировок: выделение и освобождение — один CAS
+// на голове списка свободных блоков.
+// Блоки нарезаются из одного непрерывного участка (взятого у source, например
+// StaticVectorBlocks, или через mmap), поэтому блок задаётся 32-битным номером,
+// а голова списка — 64-битным словом (поколение << 32 | номер). Поколение растёт
+// при каждой удачной смене головы, что защищает CAS от ABA: блок, снятый и
+// возвращённый другим потоком между чтением и CAS, меняет поколение.
+// Ссылки next лежат в отдельном массиве атомиков, а не внутри блоков, поэтому поток,
+// который читает next уже занятого чужим потоком блока, не гоняется с его данными.
+// Запросы больше размера блока или с выравниванием больше kAlign получают std::bad_alloc.
+class LockFreeFixedBlocks: public std::pmr::memory_resource {
+public:
+    // Участок берётся у source и возвращается ему в деструкторе.
+    LockFreeFixedBlocks(std::size_t block_size, std::size_t capacity, std::pmr::memory_resource* source)
+        : stride(stride_of(block_size)), count(capacity), source(source) {
+        assert(capacity < kNil && "слишком много блоков для 32-битного номера");
+        base = static_cast<std::byte*>(source->allocate(stride * count, kAlign));
+        link_all();
+    }
+
+    // Участок берётся напрямую у ОС.
+    LockFreeFixedBlocks(std::size_t block_size, std::size_t capacity, const osmem::MapFlags& map = {})
+        : stride(stride_of(block_size)), count(capacity) {
+        assert(capacity < kNil && "слишком много блоков для 32-битного номера");
+        mapping = osmem::map_anonymous(stride * count, map);
+        base = static_cast<std::byte*>(mapping.addr);
+        link_all();
+    }
+
+    ~LockFreeFixedBlocks() override {
+        if (source) {
+            source->deallocate(base, stride * count, kAlign);
+        } else {
+            osmem::unmap(mapping);
+        }
+    }
+
+    LockFreeFixedBlocks(const LockFreeFixedBlocks&) = delete;
+    LockFreeFixedBlocks& operator=(const LockFreeFixedBlocks&) = delete;
+
+    std::size_t block_size() const noexcept { return stride; }
+    std::size_t capacity() const noexcept { return count; }
+
+private:
+    static constexpr std::size_t kAlign = alignof(std::max_align_t);
+    static constexpr std::uint32_t kNil = 0xFFFFFFFFu;
+
+    static std::size_t stride_of(std::size_t block_size) {
+        if (block_size == 0) block_size = 1;
+        return (block_size + kAlign - 1) / kAlign * kAlign;
+    }
+
+    static std::uint32_t index_of(std::uint64_t head) { return static_cast<std::uint32_t>(head); }
+    static std::uint64_t make_head(std::uint64_t old, std::uint32_t index) {
+        return ((old >> 32) + 1) << 32 | index;
+    }
+
+    void link_all() {
+        next = std::make_unique<std::atomic<std::uint32_t>[]>(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            next[i].store(i + 1 < count ? static_cast<std::uint32_t>(i + 1) : kNil, std::memory_order_relaxed);
+        }
+        head.store(count ? 0 : kNil, std::memory_order_release);
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes > stride || alignment > kAlign) {
+            throw std::bad_alloc();
+        }
+        std::uint64_t old = head.load(std::memory_order_acquire);
+        for (;;) {
+            std::uint32_t i = index_of(old);
+            if (i == kNil) {
+                throw std::bad_alloc();
+            }
+            std::uint32_t n = next[i].load(std::memory_order_relaxed);
+            if (head.compare_exchange_weak(old, make_head(old, n), std::memory_order_acquire,
+                                           std::memory_order_acquire)) {
+                return base + std::size_t(i) * stride;
+            }
+        }
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override {
+        if (!p) {
+            return;
+        }
+        auto* b = static_cast<std::byte*>(p);
+        if (b < base || b >= base + stride * count || (b - base) % stride != 0) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+        auto i = static_cast<std::uint32_t>((b - base) / stride);
+        std::uint64_t old = head.load(std::memory_order_relaxed);
+        do {
+            next[i].store(index_of(old), std::memory_order_relaxed);
+        } while (!head.compare_exchange_weak(old, make_head(old, i), std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t stride;
+    std::size_t count;
+    std::pmr::memory_resource* source = nullptr;
+    osmem::Mapping mapping;
+    std::byte* base = nullptr;
+    std::unique_ptr<std::atomic<std::uint32_t>[]> next;
+    // Голова на отдельной строке кеша: за неё борются все потоки.
+    alignas(64) std::atomic<std::uint64_t> head{0};
+};
@@ -1,102 +1,1055 @@
 #pragma once
 #include <memory_resource>
 #include <vector>
+#include <array>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <span>
 #include <cstddef>
 #include <cstdint>
 #include <new>
 #include <cassert>
 
-class StaticVectorBlocks: public std::pmr::memory_resource {
+#include "chunk_table.hpp"
+#include "os_map.hpp"
+#include "resizable.hpp"
+
+class StaticVectorBlocks: public std::pmr::memory_resource, public InPlaceResizable, public AtLeastAllocating,
+                          public TryAllocating {
 public:
-    explicit StaticVectorBlocks(std::size_t pool_size): pool_size(pool_size) {
-        pool = ::operator new(pool_size);
-        chunks.push_back({0, pool_size, true});
+    // Стратегия выбора свободного блока.
+    //   FirstFit       — первый подходящий при проходе всей таблицы с начала пула;
+    //   NextFit        — то же, но проход начинается с места последнего выделения;
+    //   BestFit        — наименьший подходящий, через индекс свободных блоков по размеру;
+    //   AddressOrdered — первый подходящий по адресу, но проход идёт только
+    //                    по индексу свободных блоков, минуя занятые.
+    enum class Placement { FirstFit, NextFit, BestFit, AddressOrdered };
+
+    // Откуда берётся основной пул: ::operator new или mmap напрямую у ОС.
+    enum class Backing { Heap, Mmap };
+
+    struct Options {
+        Placement placement = Placement::FirstFit;
+        // Если задан upstream, то при исчерпании пула у него берётся ещё одна арена,
+        // в growth_factor раз больше предыдущей, со своей таблицей блоков.
+        // Без upstream пул фиксированный и переполнение даёт std::bad_alloc.
+        std::pmr::memory_resource* upstream = nullptr;
+        double growth_factor = 2.0;
+
+        // Только для Backing::Mmap.
+        Backing backing = Backing::Heap;
+        osmem::MapFlags map;
+        // Свободные участки основного пула не меньше этого размера отдаются ОС
+        // через MADV_DONTNEED (0 — не отдавать).
+        std::size_t release_threshold = 0;
+
+        // Обрезок-выравнивание перед блоком короче этого порога не остаётся свободным
+        // куском, а дописывается в конец предыдущего (занятого) блока и освобождается
+        // вместе с ним. Более длинные обрезки остаются свободными. 0 — не дописывать.
+        // Включается явно (например, 256): дописанные обрезки входят в used_bytes
+        // предыдущего блока, и used_bytes перестаёт совпадать с суммой запросов.
+        std::size_t absorb_pad_below = 0;
+
+        // Отложенное слияние. Освобождённый блок до kQuickMax байт не сливается с соседями,
+        // а остаётся занятым в таблице и ложится в список быстрого повторного использования
+        // своего размера (с точностью до 16 байт); выделение того же размера снимает его
+        // оттуда без поиска.
+        // Когда в списках набирается больше deferred_limit блоков или выделению не нашлось
+        // места в таблице, все они возвращаются в таблицу одним проходом слияния.
+        // Списки хранятся в самих блоках, а буфер для слияния на deferred_limit + 1
+        // указателей резервируется при создании пула, так что освобождение память не берёт.
+        // 0 — сливать при каждом освобождении.
+        std::size_t deferred_limit = 0;
+
+        // Размер региона, который кадр (mark) берёт у таблицы под выделения сдвигом вершины.
+        std::size_t frame_region = 64 * 1024;
+
+        // Только для пула поверх storage: сколько байт в конце storage отдать служебным
+        // структурам (не больше восьмой части storage). 0 — они берутся из кучи.
+        std::size_t metadata_reserve = 4096;
+    };
+
+    explicit StaticVectorBlocks(std::size_t pool_size,
+                                Placement placement = Placement::FirstFit,
+                                std::pmr::memory_resource* upstream = nullptr,
+                                double growth_factor = 2.0)
+        : StaticVectorBlocks(pool_size, make_options(placement, upstream, growth_factor)) {}
+
+    StaticVectorBlocks(std::size_t pool_size, const Options& opts)
+        : pool_size(pool_size), placement(opts.placement), upstream(opts.upstream),
+          growth_factor(opts.growth_factor), release_threshold(opts.release_threshold),
+          absorb_pad_below(opts.absorb_pad_below), deferred_limit(opts.deferred_limit),
+          frame_region(opts.frame_region) {
+        assert(growth_factor >= 1.0 && "коэффициент роста меньше 1");
+        init_quick();
+        if (opts.backing == Backing::Mmap) {
+            mapping = osmem::map_anonymous(pool_size, opts.map);
+            pool = mapping.addr;
+        } else {
+            pool = ::operator new(pool_size);
+        }
+        add_arena(static_cast<std::byte*>(pool), pool_size);
+    }
+
+    // Пул поверх чужой памяти (статический массив, стек, заранее отображённый участок):
+    // ресурс ею не владеет и не освобождает. Служебные структуры — начальная таблица
+    // блоков, индекс, списки — тоже берутся из storage, из запаса в его конце
+    // (opts.metadata_reserve), так что конструктор не ходит в кучу.
+    // Таблица, выросшая сверх запаса, берёт память у ресурса по умолчанию.
+    // backing и map из opts здесь не используются.
+    StaticVectorBlocks(std::span<std::byte> storage, const Options& opts)
+        : pool(storage.data()), pool_size(storage.size()), owns_pool(false), placement(opts.placement),
+          upstream(opts.upstream), growth_factor(opts.growth_factor), absorb_pad_below(opts.absorb_pad_below),
+          deferred_limit(opts.deferred_limit), frame_region(opts.frame_region) {
+        assert(growth_factor >= 1.0 && "коэффициент роста меньше 1");
+        std::size_t seed = std::min(opts.metadata_reserve, storage.size() / 8) & ~(kArenaAlign - 1);
+        pool_size -= seed;
+        meta.assign(storage.data() + pool_size, seed);
+        init_quick();
+        add_arena(storage.data(), pool_size);
     }
 
+    explicit StaticVectorBlocks(std::span<std::byte> storage, Placement placement = Placement::FirstFit)
+        : StaticVectorBlocks(storage, make_options(placement, nullptr, 2.0)) {}
+
     ~StaticVectorBlocks() override {
-        ::operator delete(pool);
+        for (std::size_t a = 1; a < arenas.size(); ++a) {
+            upstream->deallocate(arenas[a].base, arenas[a].size, kArenaAlign);
+        }
+        if (mapping.addr) {
+            osmem::unmap(mapping);
+        } else if (owns_pool) {
+            ::operator delete(pool);
+        }
     }
 
-private:
-    struct Chunk { 
-        std::size_t off; 
-        std::size_t sz; 
-        bool free; 
+    StaticVectorBlocks(const StaticVectorBlocks&) = delete;
+    StaticVectorBlocks& operator=(const StaticVectorBlocks&) = delete;
+
+    struct Stats {
+        std::size_t used_bytes = 0;
+        std::size_t free_bytes = 0;
+        std::size_t largest_free = 0;
+        std::size_t chunks = 0;
+        std::size_t free_chunks = 0;
+        std::size_t arenas = 0;
+        std::size_t spills = 0;               // сколько раз пул дозапрашивал арену у upstream
+        std::size_t spilled_allocations = 0;  // выделения, обслуженные не основной ареной
+        std::size_t deferred_blocks = 0;      // блоки в списках отложенного слияния (входят в used)
     };
 
-    static std::uintptr_t align_up(std::uintptr_t p, std::size_t a) {
-        return (p + (a - 1)) & ~(a - 1);
+    Stats stats() const {
+        Stats s;
+        s.arenas = arenas.size();
+        s.deferred_blocks = quick_count;
+        s.spills = spills;
+        s.spilled_allocations = spilled_allocations;
+        for (const Arena& a : arenas) {
+            s.chunks += a.chunks.size();
+            for (std::size_t i = 0; i < a.chunks.size(); ++i) {
+                Chunk c = a.chunks[i];
+                if (c.free) {
+                    ++s.free_chunks;
+                    s.free_bytes += c.sz;
+                    if (c.sz > s.largest_free) {
+                        s.largest_free = c.sz;
+                    }
+                } else {
+                    s.used_bytes += c.sz;
+                }
+            }
+        }
+        return s;
     }
 
-    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    Placement placement_policy() const noexcept { return placement; }
+
+    // Число свободных кусков короче limit байт — мелкие обрезки, которые вряд ли пригодятся.
+    std::size_t free_chunks_below(std::size_t limit) const {
+        std::size_t n = 0;
+        for (const Arena& a : arenas) {
+            for (std::size_t i = 0; i < a.chunks.size(); ++i) {
+                n += a.chunks.is_free(i) && a.chunks.sz(i) < limit;
+            }
+        }
+        return n;
+    }
+
+    // Точка отката кадра.
+    struct Mark {
+        std::size_t depth = 0;
+        std::size_t regions = 0;
+        std::byte* top = nullptr;
+    };
+
+    // Открыть кадр. Пока открыт хотя бы один кадр, все выделения идут сдвигом вершины
+    // по регионам, взятым у таблицы блоков, а освобождение блока — пустая операция
+    // (кроме последнего выделенного: вершина откатывается).
+    // release_to(m) за O(1) отбрасывает всё выделенное после mark() и закрывает кадр m
+    // вместе с вложенными; регионы, взятые после m, возвращаются в таблицу.
+    // Объекты в отброшенной памяти не уничтожаются: подходит для данных без деструкторов.
+    // Владелец памяти из кадра, переживший release_to или reset (PmrQueue, pmr-контейнер),
+    // должен забыть её до отката: для PmrQueue — abandon(), иначе его деструктор вернёт
+    // пулу уже не принадлежащий ему блок. Освобождения в регионы, отброшенные release_to,
+    // отбрасываются (assert в отладочной сборке), пока таблица не выдала их память снова;
+    // после повторной выдачи отличить их от законных нельзя.
+    Mark mark() {
+        Mark m{depth, frame_regions.size(), frame_top};
+        ++depth;
+        return m;
+    }
+
+    void release_to(const Mark& m) {
+        assert(m.depth < depth && "кадр уже закрыт");
+        while (frame_regions.size() > m.regions) {
+            table_deallocate(frame_regions.back().begin);
+            try {
+                released_frames.push_back(frame_regions.back());
+            } catch (const std::bad_alloc&) {
+                // проверка устаревших указателей — по возможности
+            }
+            frame_regions.pop_back();
+        }
+        if (m.regions == 0) {
+            frame_top = frame_end = nullptr;
+        } else {
+            frame_top = m.top;
+            frame_end = frame_regions.back().end;
+        }
+        depth = m.depth;
+    }
+
+    // Освободить всё: каждая арена снова один свободный кусок, кадры закрыты,
+    // списки отложенного слияния пусты. Арены от upstream остаются у пула.
+    void reset() {
+        for (Arena& a : arenas) {
+            a.chunks.clear();
+            a.chunks.push_back({0, a.size, true});
+            a.rover = 0;
+            a.free_index.clear();
+            index_add(a, a.chunks[0]);
+            release_free(a, 0, a.size, 0, a.size);
+        }
+        quick.fill(nullptr);
+        quick_count = 0;
+        frame_regions.clear();
+        released_frames.clear();
+        frame_top = frame_end = nullptr;
+        depth = 0;
+    }
+
+    std::size_t frame_depth() const noexcept { return depth; }
+
+    // Вернуть в таблицу и слить все блоки из списков отложенного слияния.
+    void coalesce() {
+        if (quick_count == 0) {
+            return;
+        }
+        // Ёмкость pending зарезервирована под deferred_limit + 1 блоков: здесь память не берётся.
+        assert(quick_count <= pending.capacity() && "списки отложенного слияния переполнены");
+        pending.clear();
+        for (QuickNode*& head : quick) {
+            for (; head; head = head->next) {
+                pending.push_back(head);
+            }
+        }
+        quick_count = 0;
+        deallocate_batch(pending);
+        pending.clear();
+    }
+
+    // Остаток свободного куска короче kSliver не отделяется, а отдаётся вместе с блоком.
+    SizedAllocation allocate_at_least(std::size_t bytes, std::size_t alignment) override {
+        SizedAllocation a = allocate_sized(bytes, alignment, true);
+        if (!a.ptr) {
+            throw std::bad_alloc();
+        }
+        return a;
+    }
+
+    // Как allocate, но при исчерпании пула (и upstream) — nullptr вместо std::bad_alloc.
+    // Исчерпание пула, кадра и upstream с TryAllocating доходит сюда как nullptr, без
+    // исключений; ловится только отказ в памяти под саму таблицу блоков и отказ
+    // upstream без TryAllocating.
+    void* try_allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) noexcept override {
+        try {
+            return allocate_sized(bytes, alignment, false).ptr;
+        } catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+
+    // n блоков по bytes байт за один проход по таблице: свободные куски заполняются
+    // подряд по адресу, блоки одного куска режутся одной вставкой в таблицу.
+    // Стратегия размещения здесь не используется. Каждый блок занимает bytes,
+    // округлённое вверх до alignment. Всё или ничего: если места не хватило, уже
+    // выделенное возвращается в пул и бросается std::bad_alloc.
+    void allocate_batch(std::size_t n, std::size_t bytes, std::size_t alignment, void** out) {
+        if (n == 0) {
+            return;
+        }
         if (bytes == 0) {
             bytes = 1;
         }
         if (alignment == 0) {
             alignment = alignof(std::max_align_t);
         }
+        std::size_t stride = (bytes + alignment - 1) / alignment * alignment;
 
-        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(pool);
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            Chunk &c = chunks[i];
-            if (!c.free) continue;
+        if (depth) {
+            for (std::size_t k = 0; k < n; ++k) {
+                out[k] = frame_allocate(stride, alignment).ptr;
+                if (!out[k]) {
+                    while (k-- > 0) frame_free(out[k], stride);
+                    throw std::bad_alloc();
+                }
+            }
+            return;
+        }
 
-            std::uintptr_t start = base + c.off;
-            std::uintptr_t aligned = align_up(start, alignment);
-            std::size_t pad = static_cast<std::size_t>(aligned - start);
-            if (pad + bytes > c.sz) {
+        std::size_t got = 0;
+        for (std::size_t k = 0; k < arenas.size() && got < n; ++k) {
+            std::size_t taken = fill_run(arenas[k], n - got, stride, alignment, out + got);
+            if (k > 0) {
+                spilled_allocations += taken;
+            }
+            got += taken;
+        }
+        if (got < n && upstream) {
+            if (Arena* a = grow((n - got) * stride, alignment)) {
+                std::size_t taken = fill_run(*a, n - got, stride, alignment, out + got);
+                spilled_allocations += taken;
+                got += taken;
+            }
+        }
+        if (got < n) {
+            deallocate_batch(std::span<void*>(out, got));
+            throw std::bad_alloc();
+        }
+    }
+
+    // Освобождение пачки: указатели сортируются по адресу (порядок в ptrs меняется),
+    // блоки помечаются свободными, и затронутый участок таблицы сливается одним проходом.
+    // nullptr в пачке пропускаются.
+    void deallocate_batch(std::span<void*> ptrs) {
+        if (depth || !released_frames.empty()) {
+            for (void*& p : ptrs) {
+                if (p && depth && in_frame(p)) p = nullptr;
+                if (p && in_released(p)) {
+                    assert(false && "освобождается блок из отброшенного кадра");
+                    p = nullptr;
+                }
+            }
+        }
+        std::sort(ptrs.begin(), ptrs.end(), std::less<void*>());
+        std::size_t p = 0;
+        while (p < ptrs.size() && !ptrs[p]) {
+            ++p;
+        }
+        while (p < ptrs.size()) {
+            auto [owner, first] = locate(ptrs[p]);
+            if (!owner) {
+                ++p;
                 continue;
             }
+            Arena& a = *owner;
+            ChunkTable& chunks = a.chunks;
+            std::size_t last = first;
+            for (; p < ptrs.size() && a.contains(ptrs[p]); ++p) {
+                std::size_t off = static_cast<std::size_t>(static_cast<std::byte*>(ptrs[p]) - a.base);
+                std::size_t i = chunks.lower_bound(off);
+                if (i == chunks.size() || chunks.off(i) != off || chunks.is_free(i)) {
+                    assert(false && "блок памяти не найден");
+                    continue;
+                }
+                chunks.set_free(i, true);
+                last = i;
+            }
+
+            std::size_t from = first > 0 ? first - 1 : first;
+            std::size_t to = std::min(last + 2, chunks.size());
+            release_runs(a, from, to, [&](std::size_t i) {
+                return std::binary_search(ptrs.begin(), ptrs.end(), static_cast<void*>(a.base + chunks.off(i)),
+                                          std::less<void*>());
+            });
+            chunks.coalesce(from, to);
+            if (uses_index()) {
+                rebuild_index(a);
+            }
+        }
+    }
+
+    // Блок растёт за счёт свободного соседа справа.
+    bool try_expand(void* p, std::size_t old_bytes, std::size_t new_bytes) override {
+        if (depth && in_frame(p)) {
+            // В кадре растёт только последний блок, сдвигом вершины.
+            auto* b = static_cast<std::byte*>(p);
+            if (b + old_bytes != frame_top || new_bytes > static_cast<std::size_t>(frame_end - b)) {
+                return false;
+            }
+            frame_top = b + std::max(new_bytes, old_bytes);
+            return true;
+        }
+        auto [a, i] = locate(p);
+        if (!a) {
+            return false;
+        }
+        ChunkTable& chunks = a->chunks;
+        std::size_t cur = chunks.sz(i);
+        if (new_bytes <= cur) {
+            return true;
+        }
+        std::size_t end = chunks.off(i) + cur;
+        std::size_t delta = new_bytes - cur;
+        if (i + 1 == chunks.size() || !chunks.is_free(i + 1) || chunks.off(i + 1) != end ||
+            chunks.sz(i + 1) < delta) {
+            return false;
+        }
+
+        Chunk next = chunks[i + 1];
+        index_remove(*a, next);
+        if (next.sz == delta) {
+            chunks.erase(i + 1);
+        } else {
+            chunks.set(i + 1, {next.off + delta, next.sz - delta, true});
+            index_add(*a, chunks[i + 1]);
+        }
+        chunks.set_sz(i, new_bytes);
+        reuse_released(a->base + end, delta);
+        return true;
+    }
+
+    // Хвост блока становится свободным (и сливается со свободным соседом справа).
+    bool shrink_in_place(void* p, std::size_t old_bytes, std::size_t new_bytes) override {
+        if (depth && in_frame(p)) {
+            auto* b = static_cast<std::byte*>(p);
+            if (b + old_bytes == frame_top && new_bytes > 0) {
+                frame_top = b + new_bytes;
+            }
+            return new_bytes > 0;
+        }
+        auto [a, i] = locate(p);
+        if (!a || new_bytes == 0) {
+            return false;
+        }
+        ChunkTable& chunks = a->chunks;
+        std::size_t cur = chunks.sz(i);
+        if (new_bytes >= cur) {
+            return new_bytes == cur;
+        }
+        std::size_t tail = cur - new_bytes;
+        std::size_t end = chunks.off(i) + cur;
+        chunks.set_sz(i, new_bytes);
+
+        std::size_t dirty_end = end;
+        if (i + 1 < chunks.size() && chunks.is_free(i + 1) && chunks.off(i + 1) == end) {
+            Chunk next = chunks[i + 1];
+            if (next.sz < release_threshold) {
+                dirty_end = next.off + next.sz;
+            }
+            index_remove(*a, next);
+            chunks.set(i + 1, {next.off - tail, next.sz + tail, true});
+        } else {
+            Chunk c{end - tail, tail, true};
+            chunks.insert(i + 1, &c, 1);
+        }
+        index_add(*a, chunks[i + 1]);
+        release_free(*a, chunks.off(i + 1), chunks.off(i + 1) + chunks.sz(i + 1), end - tail, dirty_end);
+        return true;
+    }
+
+private:
+    // Таблица блоков берёт память у ресурса по умолчанию только при росте
+    // сверх kInitialChunks записей; сами выделения в её память не ходят.
+    static constexpr std::size_t kInitialChunks = 64;
+    static constexpr std::size_t kArenaAlign = alignof(std::max_align_t);
+    static constexpr std::size_t kSliver = 32;
+    static constexpr std::size_t kQuickMax = 512;
+    static constexpr std::size_t kQuickLists = kQuickMax / kArenaAlign + 1;
+    static constexpr std::size_t npos = ChunkTable::npos;
+
+    using Chunk = ChunkTable::Chunk;
+
+    // Ключ индекса свободных блоков: (размер, смещение) для BestFit,
+    // (смещение, размер) для AddressOrdered. В ключе есть и off, и sz,
+    // поэтому проверка кандидата не требует обращения к таблице.
+    using FreeKey = std::pair<std::size_t, std::size_t>;
+
+    // Непрерывный кусок памяти со своей таблицей блоков; смещения считаются от base.
+    struct Arena {
+        Arena(std::byte* base, std::size_t size, std::pmr::memory_resource* mr)
+            : base(base), size(size), chunks(mr), free_index(mr) {}
+
+        std::byte* base = nullptr;
+        std::size_t size = 0;
+        std::size_t rover = 0;
+        ChunkTable chunks;
+        std::pmr::vector<FreeKey> free_index;
+
+        bool contains(const void* p) const {
+            auto* b = static_cast<const std::byte*>(p);
+            return b >= base && b < base + size;
+        }
+    };
+
+    // Память служебных структур. Запас задаётся assign; выделения идут сдвигом вершины,
+    // а не поместившиеся в запас — к ресурсу по умолчанию. Освобождённое в запасе
+    // не переиспользуется (кроме последнего блока), так что потери не больше запаса.
+    // Без assign всё идёт к ресурсу по умолчанию.
+    class Seed: public std::pmr::memory_resource {
+    public:
+        void assign(std::byte* b, std::size_t n) {
+            begin = top = b;
+            end = b + n;
+        }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            std::uintptr_t p = align_up(reinterpret_cast<std::uintptr_t>(top), alignment);
+            if (top && p <= reinterpret_cast<std::uintptr_t>(end) &&
+                bytes <= reinterpret_cast<std::uintptr_t>(end) - p) {
+                top = reinterpret_cast<std::byte*>(p + bytes);
+                return reinterpret_cast<void*>(p);
+            }
+            return fallback->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            auto* b = static_cast<std::byte*>(p);
+            if (b >= begin && b < end) {
+                if (b + bytes == top) {
+                    top = b;
+                }
+                return;
+            }
+            fallback->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::byte* begin = nullptr;
+        std::byte* top = nullptr;
+        std::byte* end = nullptr;
+        std::pmr::memory_resource* fallback = std::pmr::get_default_resource();
+    };
+
+    // Звено списка отложенного слияния, записанное в начало самого блока.
+    struct QuickNode {
+        QuickNode* next;
+    };
+
+    static bool fits_node(const void* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignof(QuickNode) == 0;
+    }
+
+    // Регион кадра — обычный занятый блок таблицы.
+    struct FrameRegion {
+        std::byte* begin;
+        std::byte* end;
+    };
+
+    static Options make_options(Placement placement, std::pmr::memory_resource* upstream, double growth_factor) {
+        Options opts;
+        opts.placement = placement;
+        opts.upstream = upstream;
+        opts.growth_factor = growth_factor;
+        return opts;
+    }
+
+    void init_quick() {
+        if (deferred_limit) {
+            pending.reserve(deferred_limit + 1);
+        }
+    }
+
+    static std::uintptr_t align_up(std::uintptr_t p, std::size_t a) {
+        return (p + (a - 1)) & ~(a - 1);
+    }
+
+    void add_arena(std::byte* base, std::size_t size) {
+        Arena& a = arenas.emplace_back(base, size, &meta);
+        a.chunks.reserve(kInitialChunks);
+        a.chunks.push_back({0, size, true});
+        if (uses_index()) {
+            a.free_index.reserve(kInitialChunks);
+            index_add(a, a.chunks[0]);
+        }
+    }
+
+    // Новая арена у upstream: не меньше запроса и в growth_factor раз больше последней.
+    // nullptr, если upstream отказал; upstream с TryAllocating спрашивается без исключений.
+    Arena* grow(std::size_t bytes, std::size_t alignment) {
+        std::size_t want = static_cast<std::size_t>(static_cast<double>(arenas.back().size) * growth_factor);
+        std::size_t need = bytes + (alignment > kArenaAlign ? alignment : 0);
+        if (want < need) {
+            want = need;
+        }
+        void* mem = nullptr;
+        if (auto* t = dynamic_cast<TryAllocating*>(upstream)) {
+            mem = t->try_allocate(want, kArenaAlign);
+        } else {
+            try {
+                mem = upstream->allocate(want, kArenaAlign);
+            } catch (const std::bad_alloc&) {
+            }
+        }
+        if (!mem) {
+            return nullptr;
+        }
+        try {
+            add_arena(static_cast<std::byte*>(mem), want);
+        } catch (...) {
+            upstream->deallocate(mem, want, kArenaAlign);
+            throw;
+        }
+        ++spills;
+        return &arenas.back();
+    }
+
+    bool uses_index() const {
+        return placement == Placement::BestFit || placement == Placement::AddressOrdered;
+    }
+
+    FreeKey key_of(const Chunk& c) const {
+        if (placement == Placement::BestFit) {
+            return {c.sz, c.off};
+        }
+        return {c.off, c.sz};
+    }
+
+    void index_add(Arena& a, const Chunk& c) {
+        if (!uses_index()) return;
+        FreeKey k = key_of(c);
+        a.free_index.insert(std::lower_bound(a.free_index.begin(), a.free_index.end(), k), k);
+    }
+
+    void rebuild_index(Arena& a) {
+        a.free_index.clear();
+        for (std::size_t i = 0; i < a.chunks.size(); ++i) {
+            if (a.chunks.is_free(i)) {
+                a.free_index.push_back(key_of(a.chunks[i]));
+            }
+        }
+        std::sort(a.free_index.begin(), a.free_index.end());
+    }
+
+    void index_remove(Arena& a, const Chunk& c) {
+        if (!uses_index()) return;
+        FreeKey k = key_of(c);
+        auto it = std::lower_bound(a.free_index.begin(), a.free_index.end(), k);
+        assert(it != a.free_index.end() && *it == k && "индекс свободных блоков рассинхронизирован");
+        a.free_index.erase(it);
+    }
+
+    static bool fits(const Arena& a, std::size_t off, std::size_t sz, std::size_t bytes, std::size_t alignment) {
+        if (sz < bytes) {
+            return false;
+        }
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(a.base) + off;
+        std::size_t pad = static_cast<std::size_t>(align_up(start, alignment) - start);
+        return pad + bytes <= sz;
+    }
+
+    std::size_t find_chunk(const Arena& a, std::size_t bytes, std::size_t alignment) const {
+        const ChunkTable& chunks = a.chunks;
+        auto fits_at = [&](std::size_t i) {
+            return fits(a, chunks.off(i), chunks.sz(i), bytes, alignment);
+        };
+
+        switch (placement) {
+        case Placement::FirstFit:
+            return chunks.find_free(0, bytes, fits_at);
+
+        case Placement::NextFit: {
+            std::size_t start = chunks.lower_bound(a.rover);
+            std::size_t i = chunks.find_free(start, bytes, fits_at);
+            if (i == npos) {
+                i = chunks.find_free(0, bytes, fits_at);
+            }
+            return i;
+        }
+
+        case Placement::BestFit: {
+            auto it = std::lower_bound(a.free_index.begin(), a.free_index.end(), FreeKey{bytes, 0});
+            for (; it != a.free_index.end(); ++it) {
+                if (fits(a, it->second, it->first, bytes, alignment)) return chunks.lower_bound(it->second);
+            }
+            return npos;
+        }
+
+        case Placement::AddressOrdered:
+            for (const FreeKey& k : a.free_index) {
+                if (fits(a, k.first, k.second, bytes, alignment)) return chunks.lower_bound(k.first);
+            }
+            return npos;
+        }
+        return npos;
+    }
 
-            std::vector<Chunk> add;
+    SizedAllocation carve(Arena& a, std::size_t i, std::size_t bytes, std::size_t alignment, bool absorb) {
+        ChunkTable& chunks = a.chunks;
+        Chunk c = chunks[i];
+        std::uintptr_t start = reinterpret_cast<std::uintptr_t>(a.base) + c.off;
+        std::uintptr_t aligned = align_up(start, alignment);
+        std::size_t pad = static_cast<std::size_t>(aligned - start);
+        index_remove(a, c);
+
+        // Короткий обрезок перед выровненным блоком уходит в предыдущий занятый блок.
+        if (pad > 0 && pad < absorb_pad_below && i > 0 && !chunks.is_free(i - 1) &&
+            chunks.off(i - 1) + chunks.sz(i - 1) == c.off) {
+            chunks.set_sz(i - 1, chunks.sz(i - 1) + pad);
+            c.off += pad;
+            c.sz -= pad;
+            pad = 0;
+        }
+
+        // Блок делится на месте: сама запись c становится занятой частью
+        // (или остаётся свободным префиксом-выравниванием), а остальные
+        // куски вставляются за ней одним сдвигом хвоста таблицы.
+        std::size_t suffix = c.sz - (pad + bytes);
+        if (absorb && suffix < kSliver) {
+            bytes += suffix;
+            suffix = 0;
+        }
+        Chunk extra[2];
+        std::size_t n = 0;
+        if (pad > 0) {
+            extra[n++] = {c.off + pad, bytes, false};
+        }
+        if (suffix > 0) {
+            extra[n++] = {c.off + pad + bytes, suffix, true};
+        }
+        chunks.insert(i + 1, extra, n);
+
+        if (pad > 0) {
+            chunks.set_sz(i, pad);
+            index_add(a, chunks[i]);
+        } else {
+            chunks.set(i, {c.off, bytes, false});
+        }
+        if (suffix > 0) {
+            index_add(a, chunks[i + n]);
+        }
+
+        a.rover = c.off + pad + bytes;
+        reuse_released(reinterpret_cast<void*>(aligned), bytes);
+        return {reinterpret_cast<void*>(aligned), bytes};
+    }
+
+    // Нарезка до n блоков с шагом stride из свободных кусков арены, по порядку адресов.
+    std::size_t fill_run(Arena& a, std::size_t n, std::size_t stride, std::size_t alignment, void** out) {
+        // Не больше kRunMax блоков на одну вставку: ChunkTable::insert берёт меньше 64 записей.
+        constexpr std::size_t kRunMax = 61;
+        ChunkTable& chunks = a.chunks;
+        auto fits_at = [&](std::size_t j) {
+            return fits(a, chunks.off(j), chunks.sz(j), stride, alignment);
+        };
+
+        std::size_t got = 0;
+        std::size_t i = 0;
+        while (got < n) {
+            i = chunks.find_free(i, stride, fits_at);
+            if (i == npos) {
+                break;
+            }
+            Chunk c = chunks[i];
+            std::uintptr_t start = reinterpret_cast<std::uintptr_t>(a.base) + c.off;
+            std::size_t pad = static_cast<std::size_t>(align_up(start, alignment) - start);
+            std::size_t k = std::min({n - got, (c.sz - pad) / stride, kRunMax});
+            std::size_t suffix = c.sz - pad - k * stride;
+
+            Chunk extra[kRunMax + 1];
+            std::size_t m = 0;
+            std::size_t first_block = pad > 0 ? 0 : 1;
+            for (std::size_t b = first_block; b < k; ++b) {
+                extra[m++] = {c.off + pad + b * stride, stride, false};
+            }
+            if (suffix > 0) {
+                extra[m++] = {c.off + pad + k * stride, suffix, true};
+            }
+
+            index_remove(a, c);
+            chunks.insert(i + 1, extra, m);
             if (pad > 0) {
-                add.push_back({c.off, pad, true});
+                chunks.set_sz(i, pad);
+                index_add(a, chunks[i]);
+            } else {
+                chunks.set(i, {c.off, stride, false});
             }
-            add.push_back({c.off + pad, bytes, false});
-            std::size_t suffix = c.sz - (pad + bytes);
             if (suffix > 0) {
-                add.push_back({c.off + pad + bytes, suffix, true});
+                index_add(a, chunks[i + m]);
             }
 
-            chunks.erase(chunks.begin() + i);
-            chunks.insert(chunks.begin() + i, add.begin(), add.end());
-            
-            return reinterpret_cast<void*>(aligned);
+            for (std::size_t b = 0; b < k; ++b) {
+                out[got++] = a.base + c.off + pad + b * stride;
+            }
+            reuse_released(a.base + c.off + pad, k * stride);
+            a.rover = c.off + pad + k * stride;
+            i += m + 1 - (suffix > 0 ? 1 : 0);
         }
-        throw std::bad_alloc();
+        return got;
     }
 
-    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* p = allocate_sized(bytes, alignment, false).ptr;
         if (!p) {
-            return;
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    // Общее ядро allocate, allocate_at_least и try_allocate: {nullptr, 0}, если места нет
+    // ни в кадре, ни в одной арене, а upstream не задан или отказал. Бросает только
+    // при отказе в памяти под таблицу блоков.
+    SizedAllocation allocate_sized(std::size_t bytes, std::size_t alignment, bool absorb) {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment == 0) {
+            alignment = alignof(std::max_align_t);
+        }
+        if (depth) {
+            return frame_allocate(bytes, alignment);
+        }
+        return table_allocate(bytes, alignment, absorb);
+    }
+
+    // Выделение через таблицу блоков, минуя кадры.
+    SizedAllocation table_allocate(std::size_t bytes, std::size_t alignment, bool absorb) {
+        // Список k держит блоки не короче k * kArenaAlign байт.
+        std::size_t k = (bytes + kArenaAlign - 1) / kArenaAlign;
+        if (k < kQuickLists && quick[k] && reinterpret_cast<std::uintptr_t>(quick[k]) % alignment == 0) {
+            QuickNode* node = quick[k];
+            quick[k] = node->next;
+            --quick_count;
+            return {node, k * kArenaAlign};
         }
 
-        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(pool);
-        std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(p);
-        if (ptr < base || ptr >= base + pool_size) {
+        for (std::size_t n = 0; n < arenas.size(); ++n) {
+            std::size_t i = find_chunk(arenas[n], bytes, alignment);
+            if (i != npos) {
+                if (n > 0) {
+                    ++spilled_allocations;
+                }
+                return carve(arenas[n], i, bytes, alignment, absorb);
+            }
+        }
+        if (quick_count) {
+            // Места не нашлось: сначала слить отложенные блоки.
+            coalesce();
+            return table_allocate(bytes, alignment, absorb);
+        }
+        if (!upstream) {
+            return {nullptr, 0};
+        }
+
+        Arena* a = grow(bytes, alignment);
+        if (!a) {
+            return {nullptr, 0};
+        }
+        std::size_t i = find_chunk(*a, bytes, alignment);
+        assert(i != npos && "новая арена не вмещает запрос");
+        ++spilled_allocations;
+        return carve(*a, i, bytes, alignment, absorb);
+    }
+
+    // Арена и номер записи занятого блока, начинающегося в p; {nullptr, npos}, если такого нет.
+    std::pair<Arena*, std::size_t> locate(void* p) {
+        auto owner = std::find_if(arenas.begin(), arenas.end(), [p](const Arena& a) { return a.contains(p); });
+        if (owner == arenas.end()) {
             assert(false && "передан неверный указатель");
+            return {nullptr, npos};
+        }
+        const ChunkTable& chunks = owner->chunks;
+        std::size_t off = static_cast<std::size_t>(static_cast<std::byte*>(p) - owner->base);
+        std::size_t i = chunks.lower_bound(off);
+        if (i == chunks.size() || chunks.off(i) != off || chunks.is_free(i)) {
+            assert(false && "блок памяти не найден");
+            return {nullptr, npos};
+        }
+        return {&*owner, i};
+    }
+
+    bool in_frame(const void* p) const {
+        auto* b = static_cast<const std::byte*>(p);
+        for (const FrameRegion& r : frame_regions) {
+            if (b >= r.begin && b < r.end) return true;
+        }
+        return false;
+    }
+
+    bool in_released(const void* p) const {
+        auto* b = static_cast<const std::byte*>(p);
+        for (const FrameRegion& r : released_frames) {
+            if (b >= r.begin && b < r.end) return true;
+        }
+        return false;
+    }
+
+    // Таблица снова выдала [b, b + n): отброшенные регионы, которые этот участок задевает,
+    // больше не отслеживаются — указатели в них снова могут быть законными.
+    void reuse_released(const void* b, std::size_t n) {
+        if (released_frames.empty()) {
             return;
         }
-        std::size_t off = static_cast<std::size_t>(ptr - base);
+        auto* lo = static_cast<const std::byte*>(b);
+        std::erase_if(released_frames, [&](const FrameRegion& r) { return r.begin < lo + n && lo < r.end; });
+    }
 
-        for (size_t i = 0; i < chunks.size(); ++i) {
-            if (chunks[i].off == off) {
-                chunks[i].free = true;
+    // Сдвиг вершины кадра; когда регион кончился, у таблицы берётся новый.
+    // {nullptr, 0}, если регион взять негде.
+    SizedAllocation frame_allocate(std::size_t bytes, std::size_t alignment) {
+        if (frame_top) {
+            std::uintptr_t p = align_up(reinterpret_cast<std::uintptr_t>(frame_top), alignment);
+            if (p <= reinterpret_cast<std::uintptr_t>(frame_end) &&
+                bytes <= reinterpret_cast<std::uintptr_t>(frame_end) - p) {
+                frame_top = reinterpret_cast<std::byte*>(p + bytes);
+                return {reinterpret_cast<void*>(p), bytes};
+            }
+        }
 
-                if (i > 0 && chunks[i-1].free && chunks[i-1].off + chunks[i-1].sz == chunks[i].off) {
-                    chunks[i - 1].sz += chunks[i].sz;
-                    chunks.erase(chunks.begin() + i);
-                    i -= 1;
-                }
+        std::size_t need = bytes + (alignment > kArenaAlign ? alignment : 0);
+        SizedAllocation r{nullptr, 0};
+        if (need < frame_region) {
+            r = table_allocate(frame_region, kArenaAlign, true);
+        }
+        if (!r.ptr) {
+            r = table_allocate(need, kArenaAlign, true);
+        }
+        if (!r.ptr) {
+            return r;
+        }
+        auto* begin = static_cast<std::byte*>(r.ptr);
+        frame_regions.push_back({begin, begin + r.bytes});
+        frame_top = begin;
+        frame_end = begin + r.bytes;
+        return frame_allocate(bytes, alignment);
+    }
+
+    // Блок кадра: вершина откатывается, только если он выделен последним.
+    void frame_free(void* p, std::size_t bytes) {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (static_cast<std::byte*>(p) + bytes == frame_top) {
+            frame_top = static_cast<std::byte*>(p);
+        }
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t) override {
+        if (!p) {
+            return;
+        }
+        if (depth && in_frame(p)) {
+            frame_free(p, bytes);
+            return;
+        }
+        if (in_released(p)) {
+            assert(false && "освобождается блок из отброшенного кадра");
+            return;
+        }
+        table_deallocate(p);
+    }
+
+    void table_deallocate(void* p) {
+        auto [owner, i] = locate(p);
+        if (!owner) {
+            return;
+        }
+        Arena& a = *owner;
+        ChunkTable& chunks = a.chunks;
+        if (deferred_limit && chunks.sz(i) >= kArenaAlign && chunks.sz(i) <= kQuickMax && fits_node(p)) {
+            // Ссылка списка пишется в начало блока; блоки с выравниванием меньше, чем у
+            // указателя (строки, массивы байт), освобождаются сразу.
+            std::size_t k = chunks.sz(i) / kArenaAlign;
+            quick[k] = ::new (p) QuickNode{quick[k]};
+            if (++quick_count > deferred_limit) {
+                coalesce();
+            }
+            return;
+        }
+
+        std::size_t off = chunks.off(i);
+        chunks.set_free(i, true);
+
+        // Участок, чьи страницы ещё не отданы ОС: сам блок и мелкие свободные соседи
+        // (см. release_free).
+        std::size_t dirty_begin = off;
+        std::size_t dirty_end = off + chunks.sz(i);
+
+        if (i > 0 && chunks.is_free(i - 1) && chunks.off(i - 1) + chunks.sz(i - 1) == chunks.off(i)) {
+            if (chunks.sz(i - 1) < release_threshold) {
+                dirty_begin = chunks.off(i - 1);
+            }
+            index_remove(a, chunks[i - 1]);
+            chunks.set_sz(i - 1, chunks.sz(i - 1) + chunks.sz(i));
+            chunks.erase(i);
+            i -= 1;
+        }
 
-                if (i + 1 < chunks.size() && chunks[i+1].free && chunks[i].off + chunks[i].sz == chunks[i+1].off) {
-                    chunks[i].sz += chunks[i + 1].sz;
-                    chunks.erase(chunks.begin() + i + 1);
+        if (i + 1 < chunks.size() && chunks.is_free(i + 1) && chunks.off(i) + chunks.sz(i) == chunks.off(i + 1)) {
+            if (chunks.sz(i + 1) < release_threshold) {
+                dirty_end = chunks.off(i + 1) + chunks.sz(i + 1);
+            }
+            index_remove(a, chunks[i + 1]);
+            chunks.set_sz(i, chunks.sz(i) + chunks.sz(i + 1));
+            chunks.erase(i + 1);
+        }
+        index_add(a, chunks[i]);
+        release_free(a, chunks.off(i), chunks.off(i) + chunks.sz(i), dirty_begin, dirty_end);
+    }
+
+    // Инвариант release_threshold: у каждого свободного куска основной арены не меньше
+    // порога страницы уже отданы ОС. Поэтому каждый путь, который создаёт или сливает
+    // свободное место, вызывает release_free для получившегося куска [begin, end),
+    // передавая [dirty_begin, dirty_end) — охват частей, которые отданы ещё не были
+    // (освобождённые блоки и мелкие свободные куски). Охват расширяется на страницу
+    // в отданные соседние части, чтобы общая с ними неполная страница тоже ушла.
+    void release_free(const Arena& a, std::size_t begin, std::size_t end, std::size_t dirty_begin,
+                      std::size_t dirty_end) {
+        if (!release_threshold || &a != &arenas.front() || end - begin < release_threshold ||
+            dirty_begin >= dirty_end) {
+            return;
+        }
+        if (dirty_begin > begin) {
+            dirty_begin = std::max(begin, dirty_begin - std::min(dirty_begin, mapping.page));
+        }
+        if (dirty_end < end) {
+            dirty_end = std::min(end, dirty_end + mapping.page);
+        }
+        osmem::release(mapping, a.base + dirty_begin, dirty_end - dirty_begin);
+    }
+
+    // release_free для каждой серии смежных свободных записей [from, to) до слияния;
+    // fresh(i) — запись i освобождена только что.
+    template <typename Fresh>
+    void release_runs(const Arena& a, std::size_t from, std::size_t to, Fresh fresh) {
+        if (!release_threshold || &a != &arenas.front()) {
+            return;
+        }
+        const ChunkTable& chunks = a.chunks;
+        std::size_t r = from;
+        while (r < to) {
+            if (!chunks.is_free(r)) {
+                ++r;
+                continue;
+            }
+            std::size_t begin = chunks.off(r);
+            std::size_t end = begin;
+            std::size_t dirty_begin = npos;
+            std::size_t dirty_end = 0;
+            for (; r < to && chunks.is_free(r) && chunks.off(r) == end; ++r) {
+                end += chunks.sz(r);
+                if (fresh(r) || chunks.sz(r) < release_threshold) {
+                    dirty_begin = std::min(dirty_begin, chunks.off(r));
+                    dirty_end = end;
                 }
-                return;
             }
+            release_free(a, begin, end, dirty_begin, dirty_end);
         }
-        assert(false && "блок памяти не найден");
     }
 
     bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
@@ -105,5 +1058,30 @@ private:
 
     void* pool = nullptr;
     std::size_t pool_size = 0;
-    std::vector<Chunk> chunks;
-};
\ No newline at end of file
+    bool owns_pool = true;
+    Placement placement = Placement::FirstFit;
+    std::pmr::memory_resource* upstream = nullptr;
+    double growth_factor = 2.0;
+    std::size_t release_threshold = 0;
+    std::size_t absorb_pad_below = 0;
+    std::size_t deferred_limit = 0;
+    Seed meta;
+    // Списки отложенного слияния по размеру блока, округлённому вниз до kArenaAlign,
+    // и буфер, через который coalesce передаёт их deallocate_batch.
+    std::array<QuickNode*, kQuickLists> quick{};
+    std::size_t quick_count = 0;
+    // (Не pending{&meta}: для vector<void*> это список из одного указателя.)
+    std::pmr::vector<void*> pending{std::pmr::polymorphic_allocator<void*>(&meta)};
+    // Кадры: регионы открытых кадров и вершина в последнем из них.
+    std::size_t frame_region = 64 * 1024;
+    std::size_t depth = 0;
+    std::pmr::vector<FrameRegion> frame_regions{&meta};
+    // Регионы, отброшенные release_to, память которых таблица ещё не выдала снова.
+    std::pmr::vector<FrameRegion> released_frames{&meta};
+    std::byte* frame_top = nullptr;
+    std::byte* frame_end = nullptr;
+    osmem::Mapping mapping;
+    std::size_t spills = 0;
+    std::size_t spilled_allocations = 0;
+    std::pmr::vector<Arena> arenas{&meta};
+};
@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cassert>
+
+#include "region_res.hpp"
+
+// Очередь-кольцо, как PmrQueue, но всё её состояние лежит в пуле RegionBlocks и вместо
+// указателей хранит смещения от начала участка. Поэтому очередь переживает повторное
+// отображение участка: после перезапуска (FileStaticVectorBlocks) или в другом процессе
+// она открывается по смещению или корню пула с тем же содержимым.
+// Элементы переносятся побайтно, поэтому T должен быть тривиально копируемым
+// (и не хранить указателей внутрь участка).
+//
+// Сам объект OffsetQueue — лёгкий дескриптор (пул и смещение состояния); его создание
+// и уничтожение на данные не влияет. Очередь из пула удаляет destroy().
+template <typename T>
+class OffsetQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "элементы переносятся побайтно");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    // Новая пустая очередь в пуле.
+    static OffsetQueue create(RegionBlocks& pool, size_type initial_capacity = 16) {
+        auto* s = static_cast<State*>(pool.allocate(sizeof(State), alignof(State)));
+        *s = State();
+        OffsetQueue q(pool, pool.offset_of(s));
+        if (initial_capacity > 0) {
+            try {
+                q.reallocate(initial_capacity);
+            } catch (...) {
+                pool.deallocate(s, sizeof(State), alignof(State));
+                throw;
+            }
+        }
+        return q;
+    }
+
+    // Дескриптор существующей очереди по смещению её состояния.
+    static OffsetQueue open(RegionBlocks& pool, std::uint64_t offset) {
+        assert(offset != 0 && "пустое смещение очереди");
+        return OffsetQueue(pool, offset);
+    }
+
+    // Очередь из корня root пула; если корень пуст — новая очередь, записанная в него.
+    static OffsetQueue at_root(RegionBlocks& pool, std::size_t root, size_type initial_capacity = 16) {
+        if (std::uint64_t off = pool.root(root)) {
+            return open(pool, off);
+        }
+        OffsetQueue q = create(pool, initial_capacity);
+        pool.set_root(root, q.offset());
+        return q;
+    }
+
+    std::uint64_t offset() const noexcept { return off; }
+    RegionBlocks& memory_resource() const noexcept { return *pool; }
+
+    void push(const T& value) {
+        State& s = state();
+        if (s.count == s.capacity) {
+            reallocate(std::max<size_type>(1, static_cast<size_type>(s.capacity) * 2));
+        }
+        std::memcpy(static_cast<void*>(slot(static_cast<size_type>(s.count))), &value, sizeof(T));
+        ++s.count;
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        push(T(std::forward<Args>(args)...));
+    }
+
+    void pop() {
+        if (empty()) throw std::out_of_range("pop from empty queue");
+        State& s = state();
+        s.head = (s.head + 1) % s.capacity;
+        --s.count;
+    }
+
+    T& front() {
+        if (empty()) throw std::out_of_range("front on empty queue");
+        return *slot(0);
+    }
+    const T& front() const {
+        if (empty()) throw std::out_of_range("front on empty queue");
+        return *slot(0);
+    }
+    T& back() {
+        if (empty()) throw std::out_of_range("back on empty queue");
+        return *slot(size() - 1);
+    }
+    const T& back() const {
+        if (empty()) throw std::out_of_range("back on empty queue");
+        return *slot(size() - 1);
+    }
+
+    // Элемент по номеру от начала очереди.
+    T& operator[](size_type i) { return *slot(i); }
+    const T& operator[](size_type i) const { return *slot(i); }
+
+    bool empty() const noexcept { return state().count == 0; }
+    size_type size() const noexcept { return static_cast<size_type>(state().count); }
+    size_type capacity() const noexcept { return static_cast<size_type>(state().capacity); }
+
+    void clear() noexcept {
+        state().head = 0;
+        state().count = 0;
+    }
+
+    // Вернуть буфер и состояние пулу. Дескриптор после этого недействителен;
+    // корень, указывающий на очередь, нужно очистить самому.
+    void destroy() {
+        State& s = state();
+        if (s.buffer) {
+            pool->deallocate(pool->at(s.buffer), static_cast<size_type>(s.capacity) * sizeof(T), alignof(T));
+        }
+        pool->deallocate(&s, sizeof(State), alignof(State));
+        off = 0;
+    }
+
+private:
+    // Лежит в пуле; только целые фиксированной ширины.
+    struct State {
+        std::uint64_t buffer = 0;
+        std::uint64_t capacity = 0;
+        std::uint64_t head = 0;
+        std::uint64_t count = 0;
+    };
+
+    OffsetQueue(RegionBlocks& pool, std::uint64_t off) : pool(&pool), off(off) {}
+
+    State& state() const { return *static_cast<State*>(pool->at(off)); }
+    T* buffer() const { return static_cast<T*>(pool->at(state().buffer)); }
+
+    T* slot(size_type i) const {
+        const State& s = state();
+        return buffer() + (s.head + i) % s.capacity;
+    }
+
+    // Новый буфер: элементы переносятся в его начало двумя memcpy, затем состояние
+    // переключается на него, и только после этого старый буфер освобождается.
+    void reallocate(size_type new_capacity) {
+        State& s = state();
+        auto* fresh = static_cast<T*>(pool->allocate(new_capacity * sizeof(T), alignof(T)));
+        size_type count = static_cast<size_type>(s.count);
+        if (count) {
+            size_type cap = static_cast<size_type>(s.capacity);
+            size_type head = static_cast<size_type>(s.head);
+            size_type first = std::min(count, cap - head);
+            std::memcpy(static_cast<void*>(fresh), buffer() + head, first * sizeof(T));
+            std::memcpy(static_cast<void*>(fresh + first), buffer(), (count - first) * sizeof(T));
+        }
+        std::uint64_t old = s.buffer;
+        size_type old_capacity = static_cast<size_type>(s.capacity);
+        s.buffer = pool->offset_of(fresh);
+        s.capacity = new_capacity;
+        s.head = 0;
+        if (old) {
+            pool->deallocate(pool->at(old), old_capacity * sizeof(T), alignof(T));
+        }
+    }
+
+    RegionBlocks* pool;
+    std::uint64_t off;
+};
@@ -0,0 +1,213 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <new>
+#include <system_error>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define LAB5_HAS_MMAP 1
+#else
+#define LAB5_HAS_MMAP 0
+#endif
+
+// Тонкая обёртка над mmap/madvise для пулов, которым нужна память напрямую от ОС.
+// На платформах без mmap map_anonymous выделяет память через ::operator new,
+// выровненную на page_size(), как и отображение, а подсказки (huge pages, populate,
+// release) просто игнорируются.
+namespace osmem {
+
+struct MapFlags {
+    bool huge_pages = false;  // MADV_HUGEPAGE: прозрачные huge pages
+    bool hugetlb = false;     // MAP_HUGETLB: явные huge pages (при отказе ядра — обычные страницы)
+    bool populate = false;    // MAP_POPULATE: сразу подкачать все страницы
+};
+
+struct Mapping {
+    void* addr = nullptr;
+    std::size_t len = 0;
+    std::size_t page = 0;  // гранулярность, с которой можно возвращать память ОС
+    bool mapped = false;
+};
+
+constexpr std::size_t kHugePage = std::size_t(2) << 20;
+
+inline std::size_t page_size() {
+#if LAB5_HAS_MMAP
+    static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return page;
+#else
+    return 4096;
+#endif
+}
+
+inline std::size_t round_up(std::size_t n, std::size_t a) {
+    return (n + a - 1) / a * a;
+}
+
+inline Mapping map_anonymous(std::size_t len, const MapFlags& flags = {}) {
+    Mapping m;
+#if LAB5_HAS_MMAP
+    int extra = 0;
+#ifdef MAP_POPULATE
+    if (flags.populate) extra |= MAP_POPULATE;
+#endif
+#ifdef MAP_HUGETLB
+    if (flags.hugetlb) {
+        std::size_t huge_len = round_up(len, kHugePage);
+        void* p = ::mmap(nullptr, huge_len, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | extra, -1, 0);
+        if (p != MAP_FAILED) {
+            return {p, huge_len, kHugePage, true};
+        }
+    }
+#endif
+    m.len = round_up(len, page_size());
+    void* p = ::mmap(nullptr, m.len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (flags.huge_pages || flags.hugetlb) {
+        ::madvise(p, m.len, MADV_HUGEPAGE);
+    }
+#endif
+    m.addr = p;
+    m.page = page_size();
+    m.mapped = true;
+#else
+    (void)flags;
+    m.addr = ::operator new(len, std::align_val_t{page_size()});
+    m.len = len;
+    m.page = 4096;
+#endif
+    return m;
+}
+
+// Описание отображения, созданного map_anonymous(len) без hugetlb, — для владельцев,
+// которые хранят только адрес и запрошенную длину.
+inline Mapping mapping_of(void* addr, std::size_t len) {
+#if LAB5_HAS_MMAP
+    return {addr, round_up(len, page_size()), page_size(), true};
+#else
+    return {addr, len, 4096, false};
+#endif
+}
+
+inline void unmap(const Mapping& m) {
+    if (!m.addr) return;
+#if LAB5_HAS_MMAP
+    if (m.mapped) {
+        ::munmap(m.addr, m.len);
+        return;
+    }
+#endif
+    ::operator delete(m.addr, std::align_val_t{page_size()});
+}
+
+// Отдать ОС целые страницы внутри [p, p + len); содержимое после этого не сохраняется.
+inline void release(const Mapping& m, void* p, std::size_t len) {
+#if LAB5_HAS_MMAP
+    if (!m.mapped || m.page == 0) return;
+    auto begin = reinterpret_cast<std::uintptr_t>(p);
+    auto end = begin + len;
+    begin = (begin + m.page - 1) / m.page * m.page;
+    end = end / m.page * m.page;
+    if (begin < end) {
+        ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+#else
+    (void)m;
+    (void)p;
+    (void)len;
+#endif
+}
+
+// Отображение len байт файла (или разделяемого сегмента) fd с MAP_SHARED.
+inline Mapping map_fd(int fd, std::size_t len) {
+#if LAB5_HAS_MMAP
+    void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    return {p, len, page_size(), true};
+#else
+    (void)fd;
+    (void)len;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported));
+#endif
+}
+
+// Файл, отображённый целиком с MAP_SHARED: записи в память попадают в файл.
+struct FileMapping {
+    Mapping map;
+    int fd = -1;
+    bool created = false;  // файл был пуст и растянут до запрошенной длины
+};
+
+// Открыть (или создать) файл path и отобразить его. Пустой файл растягивается до len,
+// непустой отображается на всю свою длину. Ошибки open/ftruncate — std::system_error,
+// ошибка mmap — std::bad_alloc.
+inline FileMapping map_file(const char* path, std::size_t len) {
+    FileMapping f;
+#if LAB5_HAS_MMAP
+    f.fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (f.fd < 0) {
+        throw std::system_error(errno, std::generic_category(), path);
+    }
+    struct stat st {};
+    if (::fstat(f.fd, &st) != 0) {
+        int err = errno;
+        ::close(f.fd);
+        throw std::system_error(err, std::generic_category(), path);
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        size = round_up(len, page_size());
+        if (::ftruncate(f.fd, static_cast<off_t>(size)) != 0) {
+            int err = errno;
+            ::close(f.fd);
+            throw std::system_error(err, std::generic_category(), path);
+        }
+        f.created = true;
+    }
+    try {
+        f.map = map_fd(f.fd, size);
+    } catch (...) {
+        ::close(f.fd);
+        throw;
+    }
+#else
+    (void)path;
+    (void)len;
+    throw std::system_error(std::make_error_code(std::errc::function_not_supported));
+#endif
+    return f;
+}
+
+// Записать изменённые страницы отображения в файл и дождаться записи.
+inline void sync(const Mapping& m) {
+#if LAB5_HAS_MMAP
+    if (m.mapped) {
+        ::msync(m.addr, m.len, MS_SYNC);
+    }
+#else
+    (void)m;
+#endif
+}
+
+inline void unmap_file(FileMapping& f) {
+    unmap(f.map);
+#if LAB5_HAS_MMAP
+    if (f.fd >= 0) {
+        ::close(f.fd);
+    }
+#endif
+    f = FileMapping();
+}
+
+}  // namespace osmem
@@ -6,6 +6,8 @@
 #include <iterator>
 #include <type_traits>
 
+#include "resizable.hpp"
+
 template <typename T>
 class PmrQueue {
 public:
@@ -28,6 +30,13 @@ public:
     template <typename... Args>
     void emplace(Args&&... args);
 
+    // Без исключений при нехватке памяти: false, если буфер не удалось расширить.
+    // Исключения конструктора T по-прежнему пробрасываются.
+    bool try_push(const T& value);
+    bool try_push(T&& value);
+    template <typename... Args>
+    bool try_emplace(Args&&... args);
+
     void pop();
     T& front();
     const T& front() const;
@@ -39,6 +48,11 @@ public:
     size_type capacity() const noexcept;
     void clear() noexcept;
     void swap(PmrQueue& other) noexcept;
+    void shrink_to_fit();
+    // Забыть буфер, не уничтожая элементы и не возвращая память ресурсу: для очередей,
+    // чья память отбрасывается целиком (StaticVectorBlocks::release_to, reset).
+    // После этого очередь пуста и её можно уничтожить или снова наполнять.
+    void abandon() noexcept;
 
     std::pmr::memory_resource* memory_resource() const noexcept;
 
@@ -64,8 +78,14 @@ private:
 
     size_type physical_index(size_type logical_index) const noexcept;
     void ensure_capacity_for_one_more();
+    bool try_ensure_capacity_for_one_more();
     void reserve(size_type new_cap);
     void reallocate_and_move(size_type new_capacity);
+    T* allocate_buffer(size_type& capacity);
+    T* try_allocate_buffer(size_type capacity) noexcept;
+    void move_into(T* new_buf, size_type new_capacity);
+    bool try_grow_in_place(size_type new_capacity);
+    InPlaceResizable* resizable() const noexcept;
     void clear_and_deallocate() noexcept;
     T& element_at(size_type logical_index);
     const T& element_at(size_type logical_index) const;
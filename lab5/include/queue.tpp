@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <utility>
 #include <new>
@@ -101,6 +102,26 @@ void PmrQueue<T>::emplace(Args&&... args) {
     ++count_;
 }
 
+template <typename T>
+bool PmrQueue<T>::try_push(const T& value) {
+    return try_emplace(value);
+}
+
+template <typename T>
+bool PmrQueue<T>::try_push(T&& value) {
+    return try_emplace(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+bool PmrQueue<T>::try_emplace(Args&&... args) {
+    if (!try_ensure_capacity_for_one_more()) return false;
+    size_type pos = physical_index(count_);
+    std::allocator_traits<allocator_type>::construct(alloc_, buffer_ + pos, std::forward<Args>(args)...);
+    ++count_;
+    return true;
+}
+
 template <typename T>
 void PmrQueue<T>::pop() {
     if (empty()) throw std::out_of_range("pop from empty queue");
@@ -158,6 +179,31 @@ void PmrQueue<T>::swap(PmrQueue& other) noexcept {
     swap(count_, other.count_);
 }
 
+template <typename T>
+void PmrQueue<T>::shrink_to_fit() {
+    size_type target = std::max<size_type>(1, count_);
+    if (target >= capacity_) return;
+    if (count_ == 0) head_ = 0;
+
+    // Если живые элементы уже лежат в начале буфера, хвост отдаётся ресурсу на месте.
+    InPlaceResizable* r = resizable();
+    if (r && head_ + count_ <= target &&
+        r->shrink_in_place(buffer_, capacity_ * sizeof(T), target * sizeof(T))) {
+        capacity_ = target;
+        return;
+    }
+    reallocate_and_move(target);
+}
+
+template <typename T>
+void PmrQueue<T>::abandon() noexcept {
+    static_assert(std::is_trivially_destructible_v<T>, "элементы без деструктора можно только отбросить");
+    buffer_ = nullptr;
+    capacity_ = 0;
+    head_ = 0;
+    count_ = 0;
+}
+
 template <typename T>
 std::pmr::memory_resource* PmrQueue<T>::memory_resource() const noexcept {
     return alloc_.resource();
@@ -201,15 +247,108 @@ void PmrQueue<T>::ensure_capacity_for_one_more() {
     reallocate_and_move(new_cap);
 }
 
+template <typename T>
+bool PmrQueue<T>::try_ensure_capacity_for_one_more() {
+    if (count_ < capacity_) return true;
+    size_type new_cap = std::max<size_type>(1, capacity_ * 2);
+    if (try_grow_in_place(new_cap)) return true;
+
+    T* new_buf = try_allocate_buffer(new_cap);
+    if (!new_buf) return false;
+    move_into(new_buf, new_cap);
+    return true;
+}
+
 template <typename T>
 void PmrQueue<T>::reserve(size_type new_cap) {
     if (new_cap <= capacity_) return;
     reallocate_and_move(new_cap);
 }
 
+template <typename T>
+InPlaceResizable* PmrQueue<T>::resizable() const noexcept {
+    return dynamic_cast<InPlaceResizable*>(alloc_.resource());
+}
+
+// Рост буфера без переноса: ресурс расширяет блок, и переносить нужно только
+// ту из двух частей кольца, что короче. Только для элементов с noexcept-перемещением,
+// чтобы исключение не оставило кольцо наполовину сдвинутым.
+template <typename T>
+bool PmrQueue<T>::try_grow_in_place(size_type new_capacity) {
+    if constexpr (!std::is_nothrow_move_constructible_v<T>) {
+        return false;
+    } else {
+        InPlaceResizable* r = resizable();
+        if (!buffer_ || !r || !r->try_expand(buffer_, capacity_ * sizeof(T), new_capacity * sizeof(T))) {
+            return false;
+        }
+
+        size_type old_capacity = capacity_;
+        size_type tail = head_ + count_ > old_capacity ? head_ + count_ - old_capacity : 0;
+        size_type extra = new_capacity - old_capacity;
+        auto relocate = [this](size_type from, size_type to) {
+            std::allocator_traits<allocator_type>::construct(alloc_, buffer_ + to, std::move(buffer_[from]));
+            std::allocator_traits<allocator_type>::destroy(alloc_, buffer_ + from);
+        };
+
+        if (tail <= old_capacity - head_ && tail <= extra) {
+            // Перенос начала кольца [0, tail) сразу за старый конец.
+            for (size_type i = 0; i < tail; ++i) relocate(i, old_capacity + i);
+        } else {
+            // Перенос куска [head_, old_capacity) в конец нового буфера, с конца.
+            size_type n = old_capacity - head_;
+            for (size_type i = n; i-- > 0;) relocate(head_ + i, new_capacity - n + i);
+            head_ = new_capacity - n;
+        }
+        capacity_ = new_capacity;
+        return true;
+    }
+}
+
+// Буфер не меньше capacity элементов; если ресурс умеет сообщать реальный размер
+// блока, capacity увеличивается до того, что в блок действительно помещается.
+template <typename T>
+T* PmrQueue<T>::allocate_buffer(size_type& capacity) {
+    if (auto* r = dynamic_cast<AtLeastAllocating*>(alloc_.resource())) {
+        if (capacity > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        SizedAllocation a = r->allocate_at_least(capacity * sizeof(T), alignof(T));
+        capacity = a.bytes / sizeof(T);
+        return static_cast<T*>(a.ptr);
+    }
+    return std::allocator_traits<allocator_type>::allocate(alloc_, capacity);
+}
+
+// nullptr при нехватке памяти. Ресурсы с TryAllocating отвечают без исключения,
+// у остальных bad_alloc перехватывается здесь.
+template <typename T>
+T* PmrQueue<T>::try_allocate_buffer(size_type capacity) noexcept {
+    if (capacity > std::numeric_limits<size_type>::max() / sizeof(T)) return nullptr;
+    std::pmr::memory_resource* mr = alloc_.resource();
+    if (auto* r = dynamic_cast<TryAllocating*>(mr)) {
+        return static_cast<T*>(r->try_allocate(capacity * sizeof(T), alignof(T)));
+    }
+    try {
+        return static_cast<T*>(mr->allocate(capacity * sizeof(T), alignof(T)));
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
 template <typename T>
 void PmrQueue<T>::reallocate_and_move(size_type new_capacity) {
-    T* new_buf = std::allocator_traits<allocator_type>::allocate(alloc_, new_capacity);
+    if (new_capacity > capacity_ && try_grow_in_place(new_capacity)) {
+        return;
+    }
+    T* new_buf = allocate_buffer(new_capacity);
+    move_into(new_buf, new_capacity);
+}
+
+// Перенос элементов в новый буфер; при исключении новый буфер освобождается,
+// а очередь остаётся прежней.
+template <typename T>
+void PmrQueue<T>::move_into(T* new_buf, size_type new_capacity) {
     size_type constructed = 0;
 
     try {
@@ -0,0 +1,242 @@
+#pragma once
+#include <memory_resource>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+// Пул, всё состояние которого — заголовок, таблица блоков и сами блоки — лежит в одном
+// непрерывном участке памяти и задаётся только смещениями от его начала. Участок можно
+// отобразить заново по другому адресу (после перезапуска, в другом процессе), и пул
+// продолжит работу с тем же содержимым.
+//
+// Раскладка участка:
+//   [Header][Entry × capacity][до границы kDataAlign][блоки ...]
+// Таблица, как у StaticVectorBlocks, упорядочена по смещению и имеет фиксированную
+// ёмкость; поиск — первый подходящий, освобождение сливает соседей. Выравнивание
+// блоков считается от начала участка (а участок выровнен по странице), поэтому
+// выравнивание больше kDataAlign не поддерживается.
+//
+// Пул участком не владеет: отображением заведуют наследники.
+class RegionBlocks: public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kRoots = 16;
+    static constexpr std::size_t kDataAlign = 4096;
+
+    RegionBlocks(const RegionBlocks&) = delete;
+    RegionBlocks& operator=(const RegionBlocks&) = delete;
+
+    struct Stats {
+        std::size_t used_bytes = 0;
+        std::size_t free_bytes = 0;
+        std::size_t largest_free = 0;
+        std::size_t chunks = 0;
+        std::size_t capacity = 0;  // предел числа записей таблицы
+    };
+
+    Stats stats() const {
+        Stats s;
+        s.chunks = static_cast<std::size_t>(header()->count);
+        s.capacity = static_cast<std::size_t>(header()->capacity);
+        for (std::size_t i = 0; i < s.chunks; ++i) {
+            const Entry& e = entries()[i];
+            if (e.free) {
+                s.free_bytes += e.sz;
+                s.largest_free = std::max<std::size_t>(s.largest_free, e.sz);
+            } else {
+                s.used_bytes += e.sz;
+            }
+        }
+        return s;
+    }
+
+    // Смещение p от начала участка и обратно; nullptr соответствует 0.
+    std::uint64_t offset_of(const void* p) const {
+        return p ? static_cast<std::uint64_t>(static_cast<const std::byte*>(p) - region) : 0;
+    }
+    void* at(std::uint64_t off) const { return off ? region + off : nullptr; }
+
+    std::byte* base() const noexcept { return region; }
+    std::size_t region_size() const noexcept { return static_cast<std::size_t>(header()->size); }
+
+    // Корни — смещения объектов верхнего уровня, по которым их находят после
+    // повторного отображения (0 — пусто).
+    std::uint64_t root(std::size_t i) const {
+        assert(i < kRoots && "номер корня вне диапазона");
+        return header()->roots[i];
+    }
+    void set_root(std::size_t i, std::uint64_t off) {
+        assert(i < kRoots && "номер корня вне диапазона");
+        header()->roots[i] = off;
+    }
+
+    // Таблица цела: записи покрывают область блоков подряд, без дыр и наложений,
+    // и соседние свободные записи слиты.
+    bool consistent() const {
+        const Header* h = header();
+        if (h->count == 0 || h->count > h->capacity) {
+            return false;
+        }
+        std::uint64_t expect = h->data_offset;
+        for (std::size_t i = 0; i < h->count; ++i) {
+            const Entry& e = entries()[i];
+            if (e.off != expect || e.sz == 0 || (i > 0 && e.free && entries()[i - 1].free)) {
+                return false;
+            }
+            expect += e.sz;
+        }
+        return expect == h->size;
+    }
+
+    // Участок уже был размечен, и пул подхватил его состояние.
+    bool restored() const noexcept { return was_restored; }
+
+    // Сколько байт займут заголовок и таблица на capacity записей.
+    static std::size_t metadata_size(std::size_t capacity) {
+        return (sizeof(Header) + capacity * sizeof(Entry) + kDataAlign - 1) / kDataAlign * kDataAlign;
+    }
+
+protected:
+    RegionBlocks() = default;
+
+    // Разметить участок заново: вся область после таблицы — один свободный блок.
+    // Признак kMagic пишется последним, чтобы недоразмеченный участок не подхватывался.
+    void format(std::byte* mem, std::size_t size, std::size_t capacity) {
+        assert(capacity >= 3 && "таблица на менее чем три записи");
+        std::size_t data = metadata_size(capacity);
+        if (size <= data) {
+            throw std::bad_alloc();
+        }
+        region = mem;
+        was_restored = false;
+        Header* h = header();
+        *h = Header();
+        h->version = kVersion;
+        h->size = size;
+        h->data_offset = data;
+        h->capacity = capacity;
+        h->count = 1;
+        entries()[0] = {data, size - data, 1};
+        h->magic = kMagic;
+    }
+
+    // Подхватить размеченный участок; false, если заголовок чужой или не той длины.
+    bool attach(std::byte* mem, std::size_t size) {
+        const Header* h = reinterpret_cast<const Header*>(mem);
+        if (size < sizeof(Header) || h->magic != kMagic || h->version != kVersion || h->size != size ||
+            metadata_size(static_cast<std::size_t>(h->capacity)) != h->data_offset) {
+            return false;
+        }
+        region = mem;
+        was_restored = true;
+        return true;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment == 0) {
+            alignment = alignof(std::max_align_t);
+        }
+        if (alignment > kDataAlign) {
+            throw std::bad_alloc();
+        }
+
+        Header* h = header();
+        Entry* e = entries();
+        std::size_t count = static_cast<std::size_t>(h->count);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!e[i].free || e[i].sz < bytes) {
+                continue;
+            }
+            std::uint64_t off = e[i].off;
+            std::uint64_t pad = (off + alignment - 1) / alignment * alignment - off;
+            if (pad + bytes > e[i].sz) {
+                continue;
+            }
+            std::uint64_t suffix = e[i].sz - pad - bytes;
+            std::size_t extra = (pad > 0) + (suffix > 0);
+            if (count + extra > h->capacity) {
+                throw std::bad_alloc();  // таблица заполнена
+            }
+
+            std::memmove(e + i + 1 + extra, e + i + 1, (count - i - 1) * sizeof(Entry));
+            std::size_t j = i;
+            if (pad > 0) {
+                e[i] = {off, pad, 1};
+                j = i + 1;
+            }
+            e[j] = {off + pad, bytes, 0};
+            if (suffix > 0) {
+                e[j + 1] = {off + pad + bytes, suffix, 1};
+            }
+            h->count = count + extra;
+            return region + off + pad;
+        }
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override {
+        if (!p) {
+            return;
+        }
+        Header* h = header();
+        Entry* e = entries();
+        std::size_t count = static_cast<std::size_t>(h->count);
+        std::uint64_t off = offset_of(p);
+        Entry* it = std::lower_bound(e, e + count, off, [](const Entry& x, std::uint64_t o) { return x.off < o; });
+        if (it == e + count || it->off != off || it->free) {
+            assert(false && "блок памяти не найден");
+            return;
+        }
+        std::size_t i = static_cast<std::size_t>(it - e);
+        e[i].free = 1;
+
+        if (i + 1 < count && e[i + 1].free) {
+            e[i].sz += e[i + 1].sz;
+            std::memmove(e + i + 1, e + i + 2, (count - i - 2) * sizeof(Entry));
+            --count;
+        }
+        if (i > 0 && e[i - 1].free) {
+            e[i - 1].sz += e[i].sz;
+            std::memmove(e + i, e + i + 1, (count - i - 1) * sizeof(Entry));
+            --count;
+        }
+        h->count = count;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr std::uint64_t kMagic = 0x4E4F49474552354Cull;  // "L5REGION" в памяти
+    static constexpr std::uint32_t kVersion = 1;
+
+    // Все поля — целые фиксированной ширины: раскладка одинакова во всех процессах.
+    struct Header {
+        std::uint64_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t size = 0;         // длина всего участка
+        std::uint64_t data_offset = 0;  // начало области блоков
+        std::uint64_t capacity = 0;     // ёмкость таблицы
+        std::uint64_t count = 0;        // записей в таблице
+        std::uint64_t roots[kRoots] = {};
+    };
+
+    struct Entry {
+        std::uint64_t off;
+        std::uint64_t sz;
+        std::uint64_t free;
+    };
+
+    Header* header() const { return reinterpret_cast<Header*>(region); }
+    Entry* entries() const { return reinterpret_cast<Entry*>(region + sizeof(Header)); }
+
+    std::byte* region = nullptr;
+    bool was_restored = false;
+};
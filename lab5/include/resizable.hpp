@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+
+// Необязательные расширения memory_resource. Контейнер узнаёт о них
+// через dynamic_cast от своего memory_resource*.
+
+// Изменение размера блока без переноса.
+class InPlaceResizable {
+public:
+    // Увеличить блок p с old_bytes до new_bytes, не перемещая его.
+    // false — если сразу за блоком нет достаточного свободного места; блок не меняется.
+    virtual bool try_expand(void* p, std::size_t old_bytes, std::size_t new_bytes) = 0;
+
+    // Уменьшить блок p до new_bytes (0 < new_bytes <= old_bytes), вернув хвост ресурсу.
+    virtual bool shrink_in_place(void* p, std::size_t old_bytes, std::size_t new_bytes) = 0;
+
+protected:
+    ~InPlaceResizable() = default;
+};
+
+struct SizedAllocation {
+    void* ptr;
+    std::size_t bytes;  // не меньше запрошенного
+};
+
+// Расширение в духе allocate_at_least из C++23: ресурс сообщает реальный размер блока,
+// если отдал больше запрошенного. Блок можно освобождать с любым размером
+// от запрошенного до возвращённого.
+class AtLeastAllocating {
+public:
+    virtual SizedAllocation allocate_at_least(std::size_t bytes, std::size_t alignment) = 0;
+
+protected:
+    ~AtLeastAllocating() = default;
+};
+
+// Выделение без исключений: при нехватке памяти возвращается nullptr.
+// Освобождается такой блок обычным deallocate.
+class TryAllocating {
+public:
+    virtual void* try_allocate(std::size_t bytes, std::size_t alignment) noexcept = 0;
+
+protected:
+    ~TryAllocating() = default;
+};
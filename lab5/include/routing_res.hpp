@@ -0,0 +1,115 @@
+#pragma once
+#include <memory_resource>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <cassert>
+
+#include "mem_res.hpp"
+#include "os_map.hpp"
+#include "slab_res.hpp"
+
+// Составной ресурс, который направляет запрос по размеру и выравниванию:
+//   Small  — до kSmallLimit байт: SlabBlocks, чьи страницы берутся из среднего пула;
+//   Medium — всё остальное ниже huge_threshold: StaticVectorBlocks;
+//   Huge   — от huge_threshold байт: отдельное отображение mmap на каждый блок,
+//            которое при освобождении сразу уходит ОС через munmap.
+// Маршрут выбирается по (bytes, alignment) и при освобождении вычисляется заново,
+// так что искать владельца по адресу не нужно.
+class RoutingBlocks: public std::pmr::memory_resource {
+public:
+    enum class Route { Small, Medium, Huge };
+
+    struct RouteStats {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes_in_use = 0;  // запрошенные байты живых блоков
+        std::size_t peak_bytes = 0;
+    };
+
+    explicit RoutingBlocks(std::size_t medium_pool_size,
+                           std::size_t huge_threshold = std::size_t(1) << 20,
+                           const StaticVectorBlocks::Options& medium_opts = StaticVectorBlocks::Options(),
+                           std::size_t slab_page = 64 * 1024)
+        : huge_threshold(huge_threshold), medium(medium_pool_size, medium_opts), small(&medium, slab_page) {
+        assert(huge_threshold > kSmallLimit && "порог huge не выше порога small");
+    }
+
+    RoutingBlocks(const RoutingBlocks&) = delete;
+    RoutingBlocks& operator=(const RoutingBlocks&) = delete;
+
+    Route route_of(std::size_t bytes, std::size_t alignment) const {
+        if (bytes <= kSmallLimit && alignment <= kSmallAlign) {
+            return Route::Small;
+        }
+        if (bytes >= huge_threshold && alignment <= osmem::page_size()) {
+            return Route::Huge;
+        }
+        return Route::Medium;
+    }
+
+    const RouteStats& stats(Route r) const { return counters[static_cast<std::size_t>(r)]; }
+
+    // Средний пул, в том числе страницы slab-ов.
+    StaticVectorBlocks::Stats medium_stats() const { return medium.stats(); }
+    std::size_t slab_pages() const noexcept { return small.page_count(); }
+
+private:
+    static constexpr std::size_t kSmallLimit = 256;
+    static constexpr std::size_t kSmallAlign = alignof(std::max_align_t);
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        Route r = route_of(bytes, alignment);
+        void* p = nullptr;
+        switch (r) {
+        case Route::Small:
+            p = small.allocate(bytes, alignment);
+            break;
+        case Route::Medium:
+            p = medium.allocate(bytes, alignment);
+            break;
+        case Route::Huge:
+            p = osmem::map_anonymous(bytes).addr;
+            break;
+        }
+
+        RouteStats& c = counters[static_cast<std::size_t>(r)];
+        ++c.allocations;
+        c.bytes_in_use += bytes;
+        if (c.bytes_in_use > c.peak_bytes) {
+            c.peak_bytes = c.bytes_in_use;
+        }
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p) {
+            return;
+        }
+        Route r = route_of(bytes, alignment);
+        switch (r) {
+        case Route::Small:
+            small.deallocate(p, bytes, alignment);
+            break;
+        case Route::Medium:
+            medium.deallocate(p, bytes, alignment);
+            break;
+        case Route::Huge:
+            osmem::unmap(osmem::mapping_of(p, bytes));
+            break;
+        }
+
+        RouteStats& c = counters[static_cast<std::size_t>(r)];
+        ++c.deallocations;
+        c.bytes_in_use -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::size_t huge_threshold;
+    StaticVectorBlocks medium;
+    SlabBlocks small;
+    std::array<RouteStats, 3> counters{};
+};
@@ -0,0 +1,234 @@
+#pragma once
+#include <memory_resource>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#if __has_include(<sched.h>)
+#include <sched.h>
+#endif
+
+#include "mem_res.hpp"
+#include "os_map.hpp"
+#include "thread_slot.hpp"
+
+// Пул, разрезанный на K независимых арен: одно резервирование памяти делится на
+// равные полосы, у каждой свой StaticVectorBlocks (своя таблица блоков) и свой мьютекс.
+// Поток выделяет из арены, выбранной по номеру CPU или по номеру потока, так что
+// разные потоки почти не встречаются на одном мьютексе.
+// Освобождение находит арену делением смещения на ширину полосы — за O(1), из любого потока.
+// Если своя арена исчерпана, выделение пробует остальные по кругу.
+//
+// Чужой поток (у которого домашняя арена другая) мьютекс арены не берёт: он кладёт
+// блок в её список удалённых освобождений — lock-free стек, узел которого записан
+// прямо в освобождаемый блок. Поток-хозяин забирает весь список одним exchange
+// при следующем выделении из арены и возвращает блоки в таблицу пачкой.
+class ShardedBlocks: public std::pmr::memory_resource {
+public:
+    using Options = StaticVectorBlocks::Options;
+
+    enum class Select {
+        Thread,  // номер потока из thread_slot
+        Cpu,     // sched_getcpu(); где его нет — как Thread
+    };
+
+    // shards == 0 — по числу аппаратных потоков.
+    // opts.backing и opts.map задают, откуда берётся общее резервирование;
+    // upstream у арен не используется, иначе адрес перестал бы определять арену.
+    explicit ShardedBlocks(std::size_t total_size, std::size_t shards = 0,
+                           Select select = Select::Thread, const Options& opts = Options())
+        : select(select) {
+        if (shards == 0) {
+            shards = std::thread::hardware_concurrency();
+            if (shards == 0) shards = 1;
+        }
+        stride = total_size / shards / kStripeAlign * kStripeAlign;
+        assert(stride > 0 && "полоса арены пустая");
+
+        if (opts.backing == StaticVectorBlocks::Backing::Mmap) {
+            mapping = osmem::map_anonymous(stride * shards, opts.map);
+            base = static_cast<std::byte*>(mapping.addr);
+        } else {
+            base = static_cast<std::byte*>(::operator new(stride * shards, std::align_val_t{kStripeAlign}));
+        }
+
+        Options arena_opts = opts;
+        arena_opts.upstream = nullptr;
+        // Полоса целиком отдаётся под блоки, таблицы арен живут в куче.
+        arena_opts.metadata_reserve = 0;
+        try {
+            arenas.reserve(shards);
+            for (std::size_t k = 0; k < shards; ++k) {
+                arenas.push_back(std::make_unique<Shard>(std::span<std::byte>(base + k * stride, stride), arena_opts));
+            }
+        } catch (...) {
+            arenas.clear();
+            free_reservation();
+            throw;
+        }
+    }
+
+    ~ShardedBlocks() override {
+        arenas.clear();
+        free_reservation();
+    }
+
+    ShardedBlocks(const ShardedBlocks&) = delete;
+    ShardedBlocks& operator=(const ShardedBlocks&) = delete;
+
+    std::size_t shard_count() const noexcept { return arenas.size(); }
+
+    // Арена, которой принадлежит адрес.
+    std::size_t shard_of(const void* p) const {
+        return static_cast<std::size_t>(static_cast<const std::byte*>(p) - base) / stride;
+    }
+
+    // Арена, из которой вызывающий поток выделяет в первую очередь.
+    std::size_t home_shard() const {
+#if __has_include(<sched.h>) && defined(__linux__)
+        if (select == Select::Cpu) {
+            int cpu = ::sched_getcpu();
+            if (cpu >= 0) {
+                return static_cast<std::size_t>(cpu) % arenas.size();
+            }
+        }
+#endif
+        return thread_slot::current() % arenas.size();
+    }
+
+    struct ShardStats {
+        StaticVectorBlocks::Stats pool;
+        std::size_t allocations = 0;
+        std::size_t stolen = 0;        // выделения потоков, чья арена была исчерпана
+        std::size_t remote_frees = 0;  // блоки, пришедшие через список удалённых освобождений
+        std::size_t drains = 0;        // сколько раз этот список забирался целиком
+    };
+
+    // Перед снимком статистики список удалённых освобождений разбирается.
+    ShardStats shard_stats(std::size_t k) {
+        Shard& s = *arenas[k];
+        std::lock_guard<std::mutex> guard(s.lock);
+        drain_remote(s);
+        return {s.blocks.stats(), s.allocations, s.stolen, s.remote_frees, s.drains};
+    }
+
+private:
+    static constexpr std::size_t kStripeAlign = 64;
+    static constexpr std::size_t kDrainBatch = 64;
+
+    // Узел списка удалённых освобождений, записанный поверх освобождённого блока.
+    struct RemoteFree {
+        RemoteFree* next;
+        std::size_t bytes;
+    };
+
+    // Арены разнесены по разным строкам кеша, чтобы мьютексы не делили строку.
+    // Голова списка удалённых освобождений — на своей строке: в неё пишут чужие потоки.
+    struct alignas(64) Shard {
+        Shard(std::span<std::byte> storage, const Options& opts) : blocks(storage, opts) {}
+
+        std::mutex lock;
+        StaticVectorBlocks blocks;
+        std::size_t allocations = 0;
+        std::size_t stolen = 0;
+        std::size_t remote_frees = 0;
+        std::size_t drains = 0;
+        alignas(64) std::atomic<RemoteFree*> remote{nullptr};
+    };
+
+    static bool fits_node(const void* p, std::size_t bytes) {
+        return bytes >= sizeof(RemoteFree) && reinterpret_cast<std::uintptr_t>(p) % alignof(RemoteFree) == 0;
+    }
+
+    // Вызывается под мьютексом арены.
+    void drain_remote(Shard& s) {
+        RemoteFree* node = s.remote.exchange(nullptr, std::memory_order_acquire);
+        if (!node) {
+            return;
+        }
+        ++s.drains;
+        // Узлы собираются в пачки по kDrainBatch и освобождаются deallocate_batch:
+        // затронутый участок таблицы сливается один раз на пачку, а не на каждый блок.
+        void* batch[kDrainBatch];
+        std::size_t n = 0;
+        while (node) {
+            RemoteFree* next = node->next;
+            batch[n++] = node;
+            ++s.remote_frees;
+            if (n == kDrainBatch) {
+                s.blocks.deallocate_batch(std::span<void*>(batch, n));
+                n = 0;
+            }
+            node = next;
+        }
+        s.blocks.deallocate_batch(std::span<void*>(batch, n));
+    }
+
+    void free_reservation() {
+        if (mapping.addr) {
+            osmem::unmap(mapping);
+        } else {
+            ::operator delete(base, std::align_val_t{kStripeAlign});
+        }
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::size_t home = home_shard();
+        for (std::size_t n = 0; n < arenas.size(); ++n) {
+            Shard& s = *arenas[(home + n) % arenas.size()];
+            std::lock_guard<std::mutex> guard(s.lock);
+            drain_remote(s);
+            try {
+                void* p = s.blocks.allocate(bytes, alignment);
+                ++s.allocations;
+                if (n > 0) {
+                    ++s.stolen;
+                }
+                return p;
+            } catch (const std::bad_alloc&) {
+            }
+        }
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p) {
+            return;
+        }
+        auto* b = static_cast<std::byte*>(p);
+        if (b < base || b >= base + stride * arenas.size()) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+        std::size_t k = shard_of(p);
+        Shard& s = *arenas[k];
+        if (k != home_shard() && fits_node(p, bytes)) {
+            auto* node = ::new (p) RemoteFree{nullptr, bytes};
+            RemoteFree* head = s.remote.load(std::memory_order_relaxed);
+            do {
+                node->next = head;
+            } while (!s.remote.compare_exchange_weak(head, node, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+            return;
+        }
+        std::lock_guard<std::mutex> guard(s.lock);
+        s.blocks.deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    Select select;
+    std::byte* base = nullptr;
+    std::size_t stride = 0;
+    osmem::Mapping mapping;
+    std::vector<std::unique_ptr<Shard>> arenas;
+};
@@ -0,0 +1,228 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include "os_map.hpp"
+#include "region_res.hpp"
+
+// Нужны разделяемые отображения, memfd_create и устойчивые разделяемые мьютексы;
+// вместе они есть только в Linux. На прочих платформах класса нет, а
+// LAB5_HAS_SHARED_POOL равен 0.
+#if LAB5_HAS_MMAP && defined(__linux__) && __has_include(<pthread.h>)
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LAB5_HAS_SHARED_POOL 1
+#else
+#define LAB5_HAS_SHARED_POOL 0
+#endif
+
+#if LAB5_HAS_SHARED_POOL
+
+// Пул в разделяемой памяти, которым пользуются несколько процессов сразу.
+// Сегмент — именованный (shm_open) или безымянный (memfd_create; его наследуют
+// дочерние процессы или получают дескриптор через SCM_RIGHTS).
+// Раскладка сегмента:
+//   [Control: признак, мьютекс — kDataAlign байт][участок RegionBlocks]
+// Таблица блоков лежит в самом сегменте, адреса внутри него — смещения
+// (OffsetQueue), поэтому процессы с разными адресами отображения работают с одними
+// и теми же блоками без копирования.
+//
+// Выделение и освобождение идут под устойчивым (PTHREAD_MUTEX_ROBUST) разделяемым
+// мьютексом. Если владелец умер с захваченным мьютексом, следующий захват проверяет
+// таблицу и, только если она цела, восстанавливает мьютекс. Повреждённую таблицу
+// мьютекс больше не защищает: он становится неисправимым (ENOTRECOVERABLE) для всех
+// процессов, и каждый захват бросает std::runtime_error. Мьютекс рекурсивный и
+// доступен снаружи (lock/unlock), чтобы под ним же менять общие очереди, выделяя из пула.
+class SharedStaticVectorBlocks: public RegionBlocks {
+public:
+    struct FromFd {
+        int fd;
+    };
+
+    // Открыть именованный сегмент name (например "/lab5-pool") или создать его
+    // на size байт с таблицей на table_capacity записей, если его ещё нет.
+    // Сегмент живёт, пока его не удалят через unlink(name).
+    SharedStaticVectorBlocks(const char* name, std::size_t size, std::size_t table_capacity = 4096) {
+        fd = ::shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd >= 0) {
+            create(size, table_capacity, name, name);
+            return;
+        }
+        if (errno != EEXIST) {
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+        fd = ::shm_open(name, O_RDWR, 0600);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+        open_existing(name);
+    }
+
+    // Безымянный сегмент на size байт (memfd_create).
+    explicit SharedStaticVectorBlocks(std::size_t size, std::size_t table_capacity = 4096) {
+        fd = ::memfd_create("lab5-shared-pool", MFD_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "memfd_create");
+        }
+        create(size, table_capacity, "memfd", nullptr);
+    }
+
+    // Сегмент, созданный другим процессом и переданный дескриптором; дескриптор
+    // переходит во владение пула.
+    explicit SharedStaticVectorBlocks(FromFd from) : fd(from.fd) { open_existing("fd"); }
+
+    ~SharedStaticVectorBlocks() override {
+        osmem::unmap(mapping);
+        ::close(fd);
+    }
+
+    static void unlink(const char* name) { ::shm_unlink(name); }
+
+    int native_handle() const noexcept { return fd; }
+
+    // Мьютекс пула. Рекурсивный: под ним можно выделять и освобождать.
+    void lock() {
+        int rc = ::pthread_mutex_lock(&control->mutex);
+        if (rc == EOWNERDEAD) {
+            if (!consistent()) {
+                // Отпускаем, не восстанавливая: мьютекс станет неисправимым.
+                ::pthread_mutex_unlock(&control->mutex);
+                throw std::runtime_error("таблица блоков повреждена умершим владельцем мьютекса");
+            }
+            ::pthread_mutex_consistent(&control->mutex);
+            ++control->owner_deaths;
+        } else if (rc == ENOTRECOVERABLE) {
+            throw std::runtime_error("пул повреждён: мьютекс неисправим");
+        } else if (rc != 0) {
+            throw std::system_error(rc, std::generic_category(), "pthread_mutex_lock");
+        }
+    }
+
+    void unlock() { ::pthread_mutex_unlock(&control->mutex); }
+
+    // Сколько раз мьютекс доставался после смерти владельца.
+    std::uint64_t owner_deaths() const noexcept { return control->owner_deaths; }
+
+    Stats stats() {
+        std::lock_guard<SharedStaticVectorBlocks> guard(*this);
+        return RegionBlocks::stats();
+    }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<SharedStaticVectorBlocks> guard(*this);
+        return RegionBlocks::do_allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::lock_guard<SharedStaticVectorBlocks> guard(*this);
+        RegionBlocks::do_deallocate(p, bytes, alignment);
+    }
+
+private:
+    static constexpr std::uint64_t kMagic = 0x4445524148533544ull;  // "D5SHARED" в памяти
+
+    struct Control {
+        std::uint64_t magic;
+        std::atomic<std::uint32_t> ready;  // 1, когда мьютекс и таблица готовы
+        std::uint32_t reserved;
+        std::uint64_t owner_deaths;
+        pthread_mutex_t mutex;
+    };
+    static_assert(sizeof(Control) <= kDataAlign, "управляющий блок не помещается в страницу");
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "атомик в разделяемой памяти");
+
+    // Создатель сегмента задаёт его длину и размечает его. При неудаче именованный
+    // сегмент (name) удаляется, чтобы следующие открытия не подхватили недоразмеченный.
+    void create(std::size_t size, std::size_t table_capacity, const char* what, const char* name) {
+        std::size_t total = osmem::round_up(kDataAlign + size, osmem::page_size());
+        try {
+            if (::ftruncate(fd, static_cast<off_t>(total)) != 0) {
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+            map(total);
+            control->magic = kMagic;
+            control->owner_deaths = 0;
+
+            pthread_mutexattr_t attr;
+            ::pthread_mutexattr_init(&attr);
+            ::pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+            ::pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+            ::pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+            int rc = ::pthread_mutex_init(&control->mutex, &attr);
+            ::pthread_mutexattr_destroy(&attr);
+            if (rc != 0) {
+                throw std::system_error(rc, std::generic_category(), "pthread_mutex_init");
+            }
+
+            format(region_start(), total - kDataAlign, table_capacity);
+            control->ready.store(1, std::memory_order_release);
+        } catch (...) {
+            osmem::unmap(mapping);
+            ::close(fd);
+            if (name) {
+                ::shm_unlink(name);
+            }
+            throw;
+        }
+    }
+
+    // Сегмент мог быть только что создан другим процессом: ждём, пока создатель
+    // задаст длину и разметит его, но не дольше kOpenTimeout.
+    void open_existing(const char* what) {
+        constexpr auto kOpenTimeout = std::chrono::seconds(5);
+        auto deadline = std::chrono::steady_clock::now() + kOpenTimeout;
+        try {
+            struct stat st {};
+            for (;;) {
+                if (::fstat(fd, &st) != 0) {
+                    throw std::system_error(errno, std::generic_category(), what);
+                }
+                if (static_cast<std::size_t>(st.st_size) > kDataAlign) break;
+                wait_until(deadline, what);
+            }
+            map(static_cast<std::size_t>(st.st_size));
+            while (control->ready.load(std::memory_order_acquire) != 1) {
+                wait_until(deadline, what);
+            }
+            if (control->magic != kMagic || !attach(region_start(), mapping.len - kDataAlign)) {
+                throw std::runtime_error(std::string(what) + ": сегмент не является пулом");
+            }
+        } catch (...) {
+            osmem::unmap(mapping);
+            ::close(fd);
+            throw;
+        }
+    }
+
+    static void wait_until(std::chrono::steady_clock::time_point deadline, const char* what) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            throw std::runtime_error(std::string(what) + ": сегмент так и не был размечен");
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    void map(std::size_t len) {
+        mapping = osmem::map_fd(fd, len);
+        control = static_cast<Control*>(mapping.addr);
+    }
+
+    std::byte* region_start() const { return static_cast<std::byte*>(mapping.addr) + kDataAlign; }
+
+    int fd = -1;
+    osmem::Mapping mapping;
+    Control* control = nullptr;
+};
+
+#endif  // LAB5_HAS_SHARED_POOL
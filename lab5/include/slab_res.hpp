@@ -0,0 +1,118 @@
+#pragma once
+#include <memory_resource>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+// Slab-ресурс для мелких объектов: под каждый класс размера из backing-ресурса
+// берутся крупные страницы, которые режутся на одинаковые слоты.
+// Выделение и освобождение — снятие/возврат указателя в список свободных слотов,
+// без отдельной записи метаданных на каждый объект.
+// Запросы больше kMaxSmall или с выравниванием больше kAlign уходят в backing напрямую.
+class SlabBlocks: public std::pmr::memory_resource {
+public:
+    explicit SlabBlocks(std::pmr::memory_resource* backing, std::size_t page_size = 64 * 1024)
+        : backing(backing), page_size(page_size) {
+        assert(page_size >= kPageHeader + kMaxSmall && "страница меньше максимального класса");
+    }
+
+    ~SlabBlocks() override {
+        while (pages) {
+            PageHeader* next = pages->next;
+            backing->deallocate(pages, page_size, kAlign);
+            pages = next;
+        }
+    }
+
+    SlabBlocks(const SlabBlocks&) = delete;
+    SlabBlocks& operator=(const SlabBlocks&) = delete;
+
+    std::size_t page_count() const noexcept { return page_num; }
+
+private:
+    static constexpr std::size_t kAlign = alignof(std::max_align_t);
+    static constexpr std::size_t kMaxSmall = 256;
+    static constexpr std::array<std::size_t, 12> kClassSize = {16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256};
+
+    struct PageHeader {
+        PageHeader* next;
+    };
+    static constexpr std::size_t kPageHeader = (sizeof(PageHeader) + kAlign - 1) / kAlign * kAlign;
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct SizeClass {
+        FreeSlot* free = nullptr;
+        std::byte* bump = nullptr;
+        std::byte* bump_end = nullptr;
+    };
+
+    static std::size_t class_of(std::size_t bytes) {
+        if (bytes <= 128) {
+            return bytes == 0 ? 0 : (bytes - 1) / 16;
+        }
+        return 8 + (bytes - 129) / 32;
+    }
+
+    void refill(SizeClass& sc) {
+        void* raw = backing->allocate(page_size, kAlign);
+        PageHeader* page = static_cast<PageHeader*>(raw);
+        page->next = pages;
+        pages = page;
+        ++page_num;
+
+        sc.bump = static_cast<std::byte*>(raw) + kPageHeader;
+        sc.bump_end = static_cast<std::byte*>(raw) + page_size;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes > kMaxSmall || alignment > kAlign) {
+            return backing->allocate(bytes, alignment);
+        }
+
+        std::size_t idx = class_of(bytes);
+        SizeClass& sc = classes[idx];
+        if (sc.free) {
+            FreeSlot* slot = sc.free;
+            sc.free = slot->next;
+            return slot;
+        }
+
+        std::size_t sz = kClassSize[idx];
+        if (static_cast<std::size_t>(sc.bump_end - sc.bump) < sz) {
+            refill(sc);
+        }
+        void* p = sc.bump;
+        sc.bump += sz;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p) {
+            return;
+        }
+        if (bytes > kMaxSmall || alignment > kAlign) {
+            backing->deallocate(p, bytes, alignment);
+            return;
+        }
+
+        SizeClass& sc = classes[class_of(bytes)];
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = sc.free;
+        sc.free = slot;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::pmr::memory_resource* backing;
+    std::size_t page_size;
+    PageHeader* pages = nullptr;
+    std::size_t page_num = 0;
+    std::array<SizeClass, kClassSize.size()> classes{};
+};
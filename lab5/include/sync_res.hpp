@@ -0,0 +1,188 @@
+#pragma once
+#include <memory_resource>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <new>
+#include <cassert>
+
+#include "mem_res.hpp"
+#include "thread_slot.hpp"
+
+// Потокобезопасная обёртка над StaticVectorBlocks.
+// Общая таблица блоков защищена мьютексом, но мелкие блоки (до kMaxCached байт,
+// выравнивание до kAlign) проходят через магазины: у каждого потока на каждый класс
+// размера есть стопка недавно освобождённых блоков. Выделение снимает блок со своей
+// стопки, освобождение кладёт на неё, и мьютекс берётся только когда стопка пуста
+// (добор kBatch блоков за один захват) или переполнена (сброс kBatch блоков).
+// Блок можно освободить в любом потоке: в пуле блоки одного класса взаимозаменяемы.
+class SyncStaticVectorBlocks: public std::pmr::memory_resource {
+public:
+    using Options = StaticVectorBlocks::Options;
+
+    explicit SyncStaticVectorBlocks(std::size_t pool_size, const Options& opts = Options())
+        : pool(pool_size, opts) {}
+
+    ~SyncStaticVectorBlocks() override {
+        // Блоки из магазинов принадлежат пулу и уходят вместе с ним.
+        for (auto& slot : slots) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+    }
+
+    SyncStaticVectorBlocks(const SyncStaticVectorBlocks&) = delete;
+    SyncStaticVectorBlocks& operator=(const SyncStaticVectorBlocks&) = delete;
+
+    struct Stats {
+        StaticVectorBlocks::Stats pool;  // блоки в магазинах здесь считаются занятыми
+        std::size_t lock_acquisitions = 0;
+    };
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> guard(lock);
+        return {pool.stats(), lock_acquisitions};
+    }
+
+    // Вернуть в пул все блоки из магазинов всех потоков.
+    // Вызывать, только когда другие потоки ресурсом не пользуются.
+    void flush() {
+        std::lock_guard<std::mutex> guard(lock);
+        ++lock_acquisitions;
+        for (auto& slot : slots) {
+            Cache* cache = slot.load(std::memory_order_acquire);
+            if (!cache) continue;
+            for (std::size_t c = 0; c < kClasses; ++c) {
+                Magazine& m = cache->mags[c];
+                while (m.count) {
+                    pool.deallocate(m.blocks[--m.count], class_size(c), kAlign);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t kAlign = alignof(std::max_align_t);
+    static constexpr std::size_t kMaxCached = 256;
+    static constexpr std::size_t kClasses = kMaxCached / kAlign;
+    static constexpr std::size_t kMagazine = 32;
+    static constexpr std::size_t kBatch = kMagazine / 2;
+    static constexpr std::size_t kMaxThreads = 64;  // потоки с большим номером идут мимо магазинов
+
+    struct Magazine {
+        std::size_t count = 0;
+        std::array<void*, kMagazine> blocks;
+    };
+
+    // Кеш одного потока; выравнивание по строке кеша, чтобы соседние потоки не делили её.
+    struct alignas(64) Cache {
+        std::array<Magazine, kClasses> mags;
+    };
+
+    static std::size_t class_of(std::size_t bytes) { return bytes == 0 ? 0 : (bytes - 1) / kAlign; }
+    static std::size_t class_size(std::size_t c) { return (c + 1) * kAlign; }
+
+    static bool cacheable(std::size_t bytes, std::size_t alignment) {
+        return bytes <= kMaxCached && alignment <= kAlign;
+    }
+
+    // Кеш вызывающего потока; создаётся при первом обращении.
+    Cache* own_cache() {
+        std::size_t id = thread_slot::current();
+        if (id >= kMaxThreads) {
+            return nullptr;
+        }
+        Cache* cache = slots[id].load(std::memory_order_acquire);
+        if (!cache) {
+            // Номер занят только этим потоком, так что гонки за слот нет.
+            cache = new Cache();
+            slots[id].store(cache, std::memory_order_release);
+        }
+        return cache;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (!cacheable(bytes, alignment)) {
+            std::lock_guard<std::mutex> guard(lock);
+            ++lock_acquisitions;
+            return pool.allocate(bytes, alignment);
+        }
+
+        std::size_t c = class_of(bytes);
+        Cache* cache = own_cache();
+        if (!cache) {
+            std::lock_guard<std::mutex> guard(lock);
+            ++lock_acquisitions;
+            return pool.allocate(class_size(c), kAlign);
+        }
+
+        Magazine& m = cache->mags[c];
+        if (m.count == 0) {
+            refill(m, c);
+        }
+        return m.blocks[--m.count];
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        if (!p) {
+            return;
+        }
+        if (!cacheable(bytes, alignment)) {
+            std::lock_guard<std::mutex> guard(lock);
+            ++lock_acquisitions;
+            pool.deallocate(p, bytes, alignment);
+            return;
+        }
+
+        std::size_t c = class_of(bytes);
+        Cache* cache = own_cache();
+        if (!cache) {
+            std::lock_guard<std::mutex> guard(lock);
+            ++lock_acquisitions;
+            pool.deallocate(p, class_size(c), kAlign);
+            return;
+        }
+
+        Magazine& m = cache->mags[c];
+        if (m.count == kMagazine) {
+            drain(m, c);
+        }
+        m.blocks[m.count++] = p;
+    }
+
+    // Добор kBatch блоков за один захват мьютекса; если пул иссяк, хватит и части.
+    void refill(Magazine& m, std::size_t c) {
+        std::lock_guard<std::mutex> guard(lock);
+        ++lock_acquisitions;
+        std::size_t sz = class_size(c);
+        try {
+            while (m.count < kBatch) {
+                void* p = pool.allocate(sz, kAlign);
+                m.blocks[m.count++] = p;
+            }
+        } catch (const std::bad_alloc&) {
+            if (m.count == 0) {
+                throw;
+            }
+        }
+    }
+
+    // Сброс старшей половины магазина обратно в пул.
+    void drain(Magazine& m, std::size_t c) {
+        std::lock_guard<std::mutex> guard(lock);
+        ++lock_acquisitions;
+        std::size_t sz = class_size(c);
+        while (m.count > kMagazine - kBatch) {
+            pool.deallocate(m.blocks[--m.count], sz, kAlign);
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    mutable std::mutex lock;
+    std::size_t lock_acquisitions = 0;
+    StaticVectorBlocks pool;
+    std::array<std::atomic<Cache*>, kMaxThreads> slots{};
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Небольшой плотный номер потока: выдаётся при первом обращении и возвращается
+// в общий пул при завершении потока, так что живые потоки занимают номера 0..N-1.
+// Ресурсы используют его как индекс в массиве потоковых кешей вместо thread_local
+// на каждый экземпляр ресурса.
+namespace thread_slot {
+
+namespace detail {
+
+struct Registry {
+    std::mutex lock;
+    std::vector<std::size_t> free_ids;
+    std::size_t next = 0;
+
+    std::size_t acquire() {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!free_ids.empty()) {
+            std::size_t id = free_ids.back();
+            free_ids.pop_back();
+            return id;
+        }
+        return next++;
+    }
+
+    void release(std::size_t id) {
+        std::lock_guard<std::mutex> guard(lock);
+        free_ids.push_back(id);
+    }
+};
+
+inline Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+struct Holder {
+    // Регистр создаётся раньше первого Holder и поэтому переживает все потоки.
+    Registry& r = registry();
+    std::size_t id = r.acquire();
+    ~Holder() { r.release(id); }
+};
+
+}  // namespace detail
+
+// Номер вызывающего потока; после завершения потока может достаться другому.
+inline std::size_t current() {
+    thread_local detail::Holder holder;
+    return holder.id;
+}
+
+}  // namespace thread_slot
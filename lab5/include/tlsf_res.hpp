@@ -0,0 +1,180 @@
+#pragma once
+#include <memory_resource>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#include "block_tags.hpp"
+
+// TLSF (two-level segregated fit): свободные блоки разложены по спискам
+// двухуровневых классов размеров, непустые списки отмечены в битовых картах.
+// Поиск подходящего списка — пара countr_zero, поэтому allocate и deallocate
+// работают за O(1) в худшем случае, независимо от числа живых блоков.
+//
+// Раскладка блока и разбиение/слияние — общие с BoundaryTagBlocks (block_tags.hpp).
+class TlsfBlocks: public std::pmr::memory_resource {
+public:
+    explicit TlsfBlocks(std::size_t pool_size): pool_size(pool_size) {
+        pool = ::operator new(pool_size);
+
+        std::size_t usable = (pool_size / kGranule) * kGranule;
+        if (usable < kMinBlock + kGranule) {
+            return;
+        }
+        std::size_t first_sz = usable - kGranule;
+        if (first_sz > kMaxBlock) {
+            first_sz = kMaxBlock;
+        }
+        insert_free(block_tags::format(base(), first_sz));
+    }
+
+    ~TlsfBlocks() override {
+        ::operator delete(pool);
+    }
+
+    TlsfBlocks(const TlsfBlocks&) = delete;
+    TlsfBlocks& operator=(const TlsfBlocks&) = delete;
+
+private:
+    using FreeLinks = block_tags::FreeLinks;
+    static constexpr std::size_t kGranule = block_tags::kGranule;
+    static constexpr std::size_t kHeader = block_tags::kHeader;
+    static constexpr std::size_t kMinBlock = block_tags::kMinBlock;
+
+    // Второй уровень делит каждый степенной класс на 2^kSlLog частей.
+    // Блоки меньше kSmallBlock попадают в класс 0 с линейным шагом kGranule.
+    static constexpr unsigned kSlLog = 5;
+    static constexpr unsigned kSlCount = 1u << kSlLog;
+    static constexpr unsigned kFlShift = kSlLog + std::countr_zero(kGranule);
+    static constexpr std::size_t kSmallBlock = std::size_t(1) << kFlShift;
+    static constexpr unsigned kFlMax = 40;
+    static constexpr unsigned kFlCount = kFlMax - kFlShift + 1;
+    static constexpr std::size_t kMaxBlock = (std::size_t(1) << kFlMax) - kGranule;
+
+    static unsigned fls(std::size_t x) {
+        return static_cast<unsigned>(std::bit_width(x)) - 1;
+    }
+
+    std::byte* base() const { return static_cast<std::byte*>(pool); }
+
+    static FreeLinks& links(std::byte* b) { return block_tags::links(b); }
+
+    static void mapping_insert(std::size_t sz, unsigned& fl, unsigned& sl) {
+        if (sz < kSmallBlock) {
+            fl = 0;
+            sl = static_cast<unsigned>(sz / (kSmallBlock / kSlCount));
+        } else {
+            unsigned f = fls(sz);
+            sl = static_cast<unsigned>(sz >> (f - kSlLog)) ^ kSlCount;
+            fl = f - (kFlShift - 1);
+        }
+    }
+
+    // Округляем вверх до границы класса, чтобы любой блок найденного списка подошёл.
+    static void mapping_search(std::size_t sz, unsigned& fl, unsigned& sl) {
+        if (sz >= kSmallBlock) {
+            sz += (std::size_t(1) << (fls(sz) - kSlLog)) - 1;
+        }
+        mapping_insert(sz, fl, sl);
+    }
+
+    void insert_free(std::byte* b) {
+        unsigned fl, sl;
+        mapping_insert(block_tags::block_size(b), fl, sl);
+        std::byte*& head = heads[fl][sl];
+        links(b) = {head, nullptr};
+        if (head) {
+            links(head).prev = b;
+        }
+        head = b;
+        fl_bitmap |= std::uint64_t(1) << fl;
+        sl_bitmap[fl] |= std::uint32_t(1) << sl;
+    }
+
+    void remove_free(std::byte* b) {
+        unsigned fl, sl;
+        mapping_insert(block_tags::block_size(b), fl, sl);
+        FreeLinks& l = links(b);
+        if (l.prev) {
+            links(l.prev).next = l.next;
+        } else {
+            heads[fl][sl] = l.next;
+        }
+        if (l.next) {
+            links(l.next).prev = l.prev;
+        }
+        if (!heads[fl][sl]) {
+            sl_bitmap[fl] &= ~(std::uint32_t(1) << sl);
+            if (!sl_bitmap[fl]) {
+                fl_bitmap &= ~(std::uint64_t(1) << fl);
+            }
+        }
+    }
+
+    std::byte* find_suitable(std::size_t need) {
+        unsigned fl, sl;
+        mapping_search(need, fl, sl);
+        if (fl >= kFlCount) {
+            return nullptr;
+        }
+
+        std::uint32_t sl_map = sl_bitmap[fl] & (~std::uint32_t(0) << sl);
+        if (!sl_map) {
+            std::uint64_t fl_map = fl_bitmap & (~std::uint64_t(0) << (fl + 1));
+            if (!fl_map) {
+                return nullptr;
+            }
+            fl = static_cast<unsigned>(std::countr_zero(fl_map));
+            sl_map = sl_bitmap[fl];
+        }
+        sl = static_cast<unsigned>(std::countr_zero(sl_map));
+        return heads[fl][sl];
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        if (alignment < kGranule) {
+            alignment = kGranule;
+        }
+        std::size_t need = block_tags::block_need(bytes, alignment);
+        if (need == 0 || need > kMaxBlock) {
+            throw std::bad_alloc();
+        }
+
+        std::byte* b = find_suitable(need);
+        if (!b) {
+            throw std::bad_alloc();
+        }
+        remove_free(b);
+        return block_tags::take(b, need, alignment, [this](std::byte* tail) { insert_free(tail); });
+    }
+
+    void do_deallocate(void* p, std::size_t, std::size_t) override {
+        if (!p) {
+            return;
+        }
+
+        std::byte* data = static_cast<std::byte*>(p);
+        if (data < base() + kHeader || data >= base() + pool_size) {
+            assert(false && "передан неверный указатель");
+            return;
+        }
+        std::byte* b = block_tags::block_of(p);
+        assert(block_tags::is_used(b) && "повторное освобождение блока");
+        insert_free(block_tags::release(b, [this](std::byte* n) { remove_free(n); }));
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    void* pool = nullptr;
+    std::size_t pool_size = 0;
+    std::uint64_t fl_bitmap = 0;
+    std::uint32_t sl_bitmap[kFlCount] = {};
+    std::byte* heads[kFlCount][kSlCount] = {};
+};
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+bool aligned_to(const void* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+}  // namespace
+
+namespace {
+
+StaticVectorBlocks::Options absorbing(std::size_t below = 256) {
+    StaticVectorBlocks::Options opts;
+    opts.absorb_pad_below = below;
+    return opts;
+}
+
+}  // namespace
+
+TEST(StaticVectorBlocksAligned, ShortPadGoesToPreviousBlock) {
+    StaticVectorBlocks pool(64 * 1024, absorbing());
+    void* small = pool.allocate(24);
+    void* line = pool.allocate(64, 64);
+    EXPECT_TRUE(aligned_to(line, 64));
+
+    // Между блоками нет свободного обрезка: только хвост пула.
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.chunks, 3u);
+    EXPECT_EQ(s.free_chunks, 1u);
+    EXPECT_EQ(pool.free_chunks_below(64), 0u);
+
+    pool.deallocate(small, 24);
+    pool.deallocate(line, 64, 64);
+    s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.free_bytes, 64u * 1024);
+}
+
+TEST(StaticVectorBlocksAligned, LongPadStaysFree) {
+    // Пул с начала страницы, чтобы обрезок до следующей страницы был заведомо длинным.
+    alignas(4096) static std::byte storage[64 * 1024];
+    StaticVectorBlocks pool{std::span<std::byte>(storage), absorbing()};
+    void* small = pool.allocate(24);
+    void* page = pool.allocate(4096, 4096);
+    EXPECT_TRUE(aligned_to(page, 4096));
+
+    // Обрезок почти в страницу пригоден для других блоков и остаётся свободным.
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.free_chunks, 2u);
+    void* filler = pool.allocate(1024);
+    EXPECT_LT(filler, page);
+
+    pool.deallocate(filler, 1024);
+    pool.deallocate(page, 4096, 4096);
+    pool.deallocate(small, 24);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksAligned, DefaultKeepsPadAndExactAccounting) {
+    // По умолчанию обрезки не дописываются: used_bytes — ровно сумма запросов.
+    StaticVectorBlocks pool(64 * 1024);
+    void* small = pool.allocate(24);
+    void* line = pool.allocate(64, 64);
+    EXPECT_EQ(pool.free_chunks_below(64), 1u);
+    EXPECT_EQ(pool.stats().used_bytes, 24u + 64);
+    pool.deallocate(line, 64, 64);
+    pool.deallocate(small, 24);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksAligned, AbsorbedPadCountsAsUsed) {
+    // С дописыванием обрезок входит в used_bytes предыдущего блока до его освобождения.
+    StaticVectorBlocks pool(64 * 1024, absorbing());
+    void* small = pool.allocate(24);
+    std::uintptr_t end = reinterpret_cast<std::uintptr_t>(small) + 24;
+    void* line = pool.allocate(64, 64);
+    std::size_t pad = reinterpret_cast<std::uintptr_t>(line) - end;
+    ASSERT_GT(pad, 0u);
+    EXPECT_EQ(pool.stats().used_bytes, 24u + pad + 64);
+
+    pool.deallocate(small, 24);
+    EXPECT_EQ(pool.stats().used_bytes, 64u);
+    pool.deallocate(line, 64, 64);
+    EXPECT_EQ(pool.stats().used_bytes, 0u);
+}
+
+namespace {
+
+// Одна и та же смесь выделений с выравниванием 16 и 64 и без дописывания обрезков;
+// возвращает число свободных кусков короче строки кеша.
+std::size_t churn_slivers(std::size_t absorb_pad_below) {
+    StaticVectorBlocks pool(1 << 20, absorbing(absorb_pad_below));
+    std::mt19937 rng(3);
+    struct Block {
+        void* p;
+        std::size_t bytes;
+        std::size_t align;
+    };
+    std::vector<Block> live;
+    for (int round = 0; round < 2000; ++round) {
+        std::size_t align = rng() % 3 == 0 ? 64 : 16;
+        std::size_t bytes = 16 * (1 + rng() % 12);
+        void* p = pool.allocate(bytes, align);
+        EXPECT_TRUE(aligned_to(p, align));
+        live.push_back({p, bytes, align});
+        if (live.size() > 100) {
+            std::size_t k = rng() % live.size();
+            pool.deallocate(live[k].p, live[k].bytes, live[k].align);
+            live.erase(live.begin() + k);
+        }
+    }
+    std::size_t slivers = pool.free_chunks_below(64);
+
+    for (const Block& b : live) {
+        pool.deallocate(b.p, b.bytes, b.align);
+    }
+    EXPECT_EQ(pool.stats().chunks, 1u);
+    return slivers;
+}
+
+}  // namespace
+
+TEST(StaticVectorBlocksAligned, MixedChurnLeavesFewerSlivers) {
+    EXPECT_LT(churn_slivers(256), churn_slivers(0));
+}
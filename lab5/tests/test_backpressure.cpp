@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "bitmap_res.hpp"
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+#include <new>
+#include <string>
+#include <string_view>
+
+TEST(StaticVectorBlocksTry, ReturnsNullWhenExhausted) {
+    StaticVectorBlocks pool(1024);
+    void* a = pool.try_allocate(1000);
+    ASSERT_NE(a, nullptr);
+    EXPECT_EQ(pool.try_allocate(100), nullptr);
+    EXPECT_EQ(pool.stats().used_bytes, 1000u);
+    pool.deallocate(a, 1000);
+    EXPECT_NE(pool.try_allocate(100), nullptr);
+}
+
+TEST(StaticVectorBlocksTry, UpstreamStillUsed) {
+    StaticVectorBlocks pool(256, StaticVectorBlocks::Placement::FirstFit, std::pmr::new_delete_resource());
+    void* p = pool.try_allocate(4096);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(pool.stats().arenas, 2u);
+    pool.deallocate(p, 4096);
+}
+
+namespace {
+
+// Upstream, который отказывает только через try_allocate: обычный allocate — ошибка теста.
+class RefusingUpstream: public std::pmr::memory_resource, public TryAllocating {
+public:
+    void* try_allocate(std::size_t, std::size_t) noexcept override {
+        ++refusals;
+        return nullptr;
+    }
+    int refusals = 0;
+
+private:
+    void* do_allocate(std::size_t, std::size_t) override {
+        ADD_FAILURE() << "upstream спрошен через allocate";
+        throw std::bad_alloc();
+    }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+}  // namespace
+
+TEST(StaticVectorBlocksTry, TryAllocatingUpstreamAskedWithoutExceptions) {
+    RefusingUpstream upstream;
+    StaticVectorBlocks pool(256, StaticVectorBlocks::Placement::FirstFit, &upstream);
+    EXPECT_EQ(pool.try_allocate(4096), nullptr);
+    EXPECT_EQ(upstream.refusals, 1);
+    EXPECT_THROW((void)pool.allocate(4096), std::bad_alloc);
+    EXPECT_EQ(upstream.refusals, 2);
+    EXPECT_EQ(pool.stats().arenas, 1u);
+}
+
+TEST(StaticVectorBlocksTry, ReturnsNullInFrame) {
+    StaticVectorBlocks::Options opts;
+    opts.frame_region = 1024;
+    StaticVectorBlocks pool(4096, opts);
+    StaticVectorBlocks::Mark m = pool.mark();
+    while (pool.try_allocate(512)) {
+    }
+    EXPECT_EQ(pool.try_allocate(512), nullptr);
+    EXPECT_THROW((void)pool.allocate(512), std::bad_alloc);
+    pool.release_to(m);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(PmrQueueTryPush, ReportsFullPoolWithoutThrowing) {
+    StaticVectorBlocks pool(64 * sizeof(int) + 8 * sizeof(int));
+    PmrQueue<int> q(8, &pool);
+
+    int pushed = 0;
+    while (q.try_push(pushed)) ++pushed;
+    // Буфер растёт на месте до 64 элементов; следующее удвоение в пул не помещается,
+    // и очередь при этом остаётся целой.
+    EXPECT_EQ(pushed, 64);
+    EXPECT_EQ(static_cast<std::size_t>(pushed), q.size());
+    EXPECT_FALSE(q.try_emplace(-1));
+
+    q.pop();
+    EXPECT_TRUE(q.try_push(pushed));
+    for (int i = 1; i <= pushed; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+}
+
+TEST(PmrQueueTryPush, FallsBackForOtherResources) {
+    BitmapBlocks pool(4096);
+    PmrQueue<std::pmr::string> q(4, &pool);
+    int pushed = 0;
+    while (q.try_emplace("message_" + std::to_string(pushed))) ++pushed;
+    EXPECT_GT(pushed, 4);
+    for (int i = 0; i < pushed; ++i) {
+        EXPECT_EQ(std::string_view(q.front()), "message_" + std::to_string(i));
+        q.pop();
+    }
+}
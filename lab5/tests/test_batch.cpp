@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using Placement = StaticVectorBlocks::Placement;
+
+TEST(StaticVectorBlocksBatch, CarvesContiguousRunAndCoalescesBack) {
+    StaticVectorBlocks pool(64 * 1024);
+    std::vector<void*> blocks(300);
+    pool.allocate_batch(blocks.size(), 48, 16, blocks.data());
+
+    for (std::size_t i = 1; i < blocks.size(); ++i) {
+        EXPECT_EQ(static_cast<char*>(blocks[i]), static_cast<char*>(blocks[i - 1]) + 48);
+    }
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.used_bytes, 300u * 48);
+    EXPECT_EQ(s.chunks, 301u);
+
+    std::shuffle(blocks.begin(), blocks.end(), std::mt19937(5));
+    pool.deallocate_batch(blocks);
+    s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.free_bytes, 64u * 1024);
+}
+
+TEST(StaticVectorBlocksBatch, FillsHolesInAddressOrder) {
+    for (Placement policy : {Placement::FirstFit, Placement::BestFit, Placement::AddressOrdered}) {
+        StaticVectorBlocks pool(4096, policy);
+        std::vector<void*> singles;
+        for (int i = 0; i < 16; ++i) singles.push_back(pool.allocate(64));
+        // Дыры по 128 байт через одну.
+        for (int i = 0; i < 16; i += 4) {
+            pool.deallocate(singles[i], 64);
+            pool.deallocate(singles[i + 1], 64);
+        }
+
+        std::vector<void*> batch(10);
+        pool.allocate_batch(batch.size(), 64, 16, batch.data());
+        std::set<void*> holes;
+        for (int i = 0; i < 16; i += 4) {
+            holes.insert(singles[i]);
+            holes.insert(singles[i + 1]);
+        }
+        for (int i = 0; i < 8; ++i) EXPECT_TRUE(holes.count(batch[i]));
+        EXPECT_EQ(static_cast<char*>(batch[8]), static_cast<char*>(singles[15]) + 64);
+
+        pool.deallocate_batch(batch);
+        for (int i = 0; i < 16; ++i) {
+            if (i % 4 >= 2) pool.deallocate(singles[i], 64);
+        }
+        EXPECT_EQ(pool.stats().chunks, 1u);
+        // Индекс свободных блоков после пачек согласован с таблицей.
+        void* all = pool.allocate(4096);
+        pool.deallocate(all, 4096);
+    }
+}
+
+TEST(StaticVectorBlocksBatch, AllOrNothing) {
+    StaticVectorBlocks pool(1024);
+    void* keep = pool.allocate(100);
+    std::vector<void*> batch(20);
+    EXPECT_THROW(pool.allocate_batch(batch.size(), 64, 16, batch.data()), std::bad_alloc);
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.used_bytes, 100u);
+    EXPECT_EQ(s.chunks, 2u);
+    pool.deallocate(keep, 100);
+}
+
+TEST(StaticVectorBlocksBatch, SpillsRemainderToUpstream) {
+    StaticVectorBlocks pool(1024, Placement::FirstFit, std::pmr::new_delete_resource());
+    std::vector<void*> batch(100);
+    pool.allocate_batch(batch.size(), 32, 16, batch.data());
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.arenas, 2u);
+    EXPECT_EQ(s.spilled_allocations, 100u - 1024 / 32);
+
+    pool.deallocate_batch(batch);
+    EXPECT_EQ(pool.stats().chunks, 2u);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include "bitmap_res.hpp"
+#include "queue.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST(BitmapBlocks, QueueGrowthPreservesOrder) {
+    BitmapBlocks pool(64 * 1024);
+    PmrQueue<int> q(2, &pool);
+
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+    EXPECT_EQ(pool.used_granules(), q.capacity() * sizeof(int) / 16);
+}
+
+TEST(BitmapBlocks, FreedNeighboursFormOneRun) {
+    BitmapBlocks pool(200 * 16);  // 200 гранул, не кратно 64
+
+    void* a = pool.allocate(60 * 16);
+    void* b = pool.allocate(60 * 16);
+    void* c = pool.allocate(60 * 16);
+    EXPECT_THROW((void)pool.allocate(30 * 16), std::bad_alloc);
+
+    pool.deallocate(a, 60 * 16);
+    pool.deallocate(b, 60 * 16);
+    // Участок пересекает границы слов карты.
+    void* ab = pool.allocate(120 * 16);
+    EXPECT_EQ(ab, a);
+
+    pool.deallocate(ab, 120 * 16);
+    pool.deallocate(c, 60 * 16);
+    EXPECT_EQ(pool.used_granules(), 0u);
+    EXPECT_NO_THROW(pool.deallocate(pool.allocate(200 * 16), 200 * 16));
+}
+
+TEST(BitmapBlocks, AlignmentAndLargerGranule) {
+    BitmapBlocks pool(64 * 1024, 64);
+    EXPECT_EQ(pool.granule_size(), 64u);
+
+    void* small = pool.allocate(1);
+    void* aligned = pool.allocate(100, 1024);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 1024, 0u);
+    EXPECT_EQ(pool.used_granules(), 3u);
+
+    pool.deallocate(small, 1);
+    pool.deallocate(aligned, 100, 1024);
+    EXPECT_EQ(pool.used_granules(), 0u);
+}
+
+TEST(BitmapBlocks, RandomChurnKeepsBlocksDisjoint) {
+    BitmapBlocks pool(1 << 20);
+    std::mt19937 rng(5);
+
+    struct Live { unsigned char* p; std::size_t n; unsigned char tag; };
+    std::vector<Live> live;
+    for (int step = 0; step < 20000; ++step) {
+        if (!live.empty() && (rng() % 2 == 0 || live.size() > 300)) {
+            std::size_t i = rng() % live.size();
+            for (std::size_t k = 0; k < live[i].n; ++k) {
+                ASSERT_EQ(live[i].p[k], live[i].tag);
+            }
+            pool.deallocate(live[i].p, live[i].n);
+            live[i] = live.back();
+            live.pop_back();
+        } else {
+            std::size_t n = 1 + rng() % 2000;
+            auto* p = static_cast<unsigned char*>(pool.allocate(n));
+            unsigned char tag = static_cast<unsigned char>(step);
+            std::fill(p, p + n, tag);
+            live.push_back({p, n, tag});
+        }
+    }
+    for (auto& l : live) pool.deallocate(l.p, l.n);
+    EXPECT_EQ(pool.used_granules(), 0u);
+}
+
+TEST(BitmapBlocks, LongUniformStretchesAreSkipped) {
+    // Длинные полностью занятые и полностью свободные участки карты (больше 256 бит)
+    // пропускаются пачками слов: проверяем, что границы участков при этом не теряются.
+    BitmapBlocks pool(4096 * 16);
+    void* head = pool.allocate(3000 * 16);
+    void* hole = pool.allocate(5 * 16);
+    void* mid = pool.allocate(600 * 16);
+    pool.deallocate(hole, 5 * 16);
+
+    EXPECT_EQ(pool.allocate(5 * 16), hole);
+    EXPECT_EQ(pool.allocate(400 * 16), static_cast<std::byte*>(mid) + 600 * 16);
+    EXPECT_THROW((void)pool.allocate(100 * 16), std::bad_alloc);
+
+    pool.deallocate(head, 3000 * 16);
+    void* big = pool.allocate(2990 * 16);
+    EXPECT_EQ(big, head);
+}
@@ -0,0 +1,23 @@
+#include <gtest/gtest.h>
+
+#include "boundary_tag_res.hpp"
+
+#include <vector>
+
+TEST(BoundaryTagBlocks, CoalescesNeighboursOnFree) {
+    const std::size_t pool_size = 4096;
+    BoundaryTagBlocks pool(pool_size);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) {
+        blocks.push_back(pool.allocate(200));
+    }
+    // Освобождаем вперемешку, чтобы задействовать слияние и слева, и справа.
+    for (int i : {1, 3, 0, 2, 6, 4, 7, 5}) {
+        pool.deallocate(blocks[i], 200);
+    }
+
+    void* big = nullptr;
+    EXPECT_NO_THROW(big = pool.allocate(pool_size / 2));
+    pool.deallocate(big, pool_size / 2);
+}
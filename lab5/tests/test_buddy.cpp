@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include "buddy_res.hpp"
+
+#include <cstdint>
+#include <vector>
+
+TEST(BuddyBlocks, SplitsAndMergesBuddies) {
+    BuddyBlocks pool(4096);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 16; ++i) {
+        blocks.push_back(pool.allocate(256));
+    }
+    EXPECT_EQ(pool.stats().free_bytes, 0u);
+    EXPECT_THROW((void)pool.allocate(16), std::bad_alloc);
+
+    for (void* p : blocks) pool.deallocate(p, 256);
+    BuddyBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.free_bytes, 4096u);
+    EXPECT_EQ(s.largest_free, 4096u);
+}
+
+TEST(BuddyBlocks, ReportsInternalFragmentation) {
+    BuddyBlocks pool(64 * 1024);
+
+    void* a = pool.allocate(100);   // блок 128
+    void* b = pool.allocate(1000);  // блок 1024
+
+    BuddyBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.requested_bytes, 1100u);
+    EXPECT_EQ(s.used_bytes, 1152u);
+    EXPECT_NEAR(s.internal_fragmentation(), 1.0 - 1100.0 / 1152.0, 1e-9);
+
+    pool.deallocate(a, 100);
+    pool.deallocate(b, 1000);
+    EXPECT_EQ(pool.stats().used_bytes, 0u);
+}
+
+TEST(BuddyBlocks, NonPowerOfTwoPoolAndAlignment) {
+    BuddyBlocks pool(3 * 4096 + 512);
+    void* p = pool.allocate(64, 1024);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 1024, 0u);
+    void* big = pool.allocate(8192);
+    pool.deallocate(p, 64, 1024);
+    pool.deallocate(big, 8192);
+    EXPECT_EQ(pool.stats().free_bytes, 3u * 4096 + 512);
+}
+
+TEST(BuddyBlocks, MetadataCoversOnlyUsedOrders) {
+    // Карты нужны только порядкам от 16 байт: вместе не больше 1/64 пула
+    // (плюс округление до слова на каждый порядок).
+    const std::size_t size = 1 << 20;
+    BuddyBlocks pool(size);
+    EXPECT_LE(pool.stats().metadata_bytes, size / 64 + 48 * sizeof(std::uint64_t));
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+StaticVectorBlocks::Options deferred(std::size_t limit) {
+    StaticVectorBlocks::Options opts;
+    opts.deferred_limit = limit;
+    return opts;
+}
+
+}  // namespace
+
+TEST(StaticVectorBlocksDeferred, SameSizeIsReusedWithoutTableChanges) {
+    StaticVectorBlocks pool(64 * 1024, deferred(64));
+    void* a = pool.allocate(48);
+    void* b = pool.allocate(48);
+    void* c = pool.allocate(48);
+    std::size_t chunks = pool.stats().chunks;
+
+    pool.deallocate(b, 48);
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.chunks, chunks);
+    EXPECT_EQ(s.deferred_blocks, 1u);
+
+    EXPECT_EQ(pool.allocate(48), b);
+    EXPECT_EQ(pool.stats().deferred_blocks, 0u);
+
+    // Больший размер идёт мимо списка.
+    pool.deallocate(b, 48);
+    void* d = pool.allocate(96);
+    EXPECT_NE(d, b);
+
+    for (void* p : {a, c}) pool.deallocate(p, 48);
+    pool.deallocate(d, 96);
+    pool.coalesce();
+    s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.deferred_blocks, 0u);
+}
+
+TEST(StaticVectorBlocksDeferred, LimitTriggersCoalescing) {
+    StaticVectorBlocks pool(64 * 1024, deferred(8));
+    std::vector<void*> blocks;
+    for (int i = 0; i < 20; ++i) blocks.push_back(pool.allocate(64));
+    for (int i = 0; i < 9; ++i) pool.deallocate(blocks[i], 64);
+
+    // Девятый блок переполнил списки: всё слито в один свободный кусок в начале.
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.deferred_blocks, 0u);
+    EXPECT_EQ(s.free_chunks, 2u);
+    EXPECT_EQ(pool.free_chunks_below(9 * 64), 0u);
+
+    for (int i = 9; i < 20; ++i) pool.deallocate(blocks[i], 64);
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksDeferred, MissCoalescesBeforeFailing) {
+    StaticVectorBlocks pool(4096, deferred(1000));
+    std::vector<void*> blocks;
+    for (int i = 0; i < 64; ++i) blocks.push_back(pool.allocate(64));
+    EXPECT_THROW((void)pool.allocate(16), std::bad_alloc);
+    for (void* p : blocks) pool.deallocate(p, 64);
+    EXPECT_EQ(pool.stats().free_bytes, 0u);
+
+    void* big = pool.allocate(2048);
+    EXPECT_EQ(pool.stats().deferred_blocks, 0u);
+    pool.deallocate(big, 2048);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksDeferred, RandomChurnMatchesEagerAccounting) {
+    StaticVectorBlocks pool(1 << 20, deferred(32));
+    std::mt19937 rng(9);
+    std::vector<std::pair<void*, std::size_t>> live;
+    for (int round = 0; round < 5000; ++round) {
+        std::size_t bytes = 16 * (1 + rng() % 40);
+        live.emplace_back(pool.allocate(bytes), bytes);
+        if (live.size() > 200) {
+            std::size_t k = rng() % live.size();
+            pool.deallocate(live[k].first, live[k].second);
+            live.erase(live.begin() + k);
+        }
+    }
+    std::size_t live_bytes = 0;
+    for (auto& [p, bytes] : live) live_bytes += bytes;
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().used_bytes, live_bytes);
+
+    for (auto& [p, bytes] : live) pool.deallocate(p, bytes);
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksDeferred, OddLengthStringsAreFreedEagerly) {
+    // pmr::string просит capacity + 1 байт с выравниванием 1: следующие блоки лежат
+    // по невыровненным адресам, и ссылку списка в них класть нельзя.
+    StaticVectorBlocks pool(256 * 1024, deferred(64));
+    void* odd = pool.allocate(17, 1);
+    void* next = pool.allocate(40, 1);
+    ASSERT_NE(reinterpret_cast<std::uintptr_t>(next) % alignof(void*), 0u);
+    pool.deallocate(next, 40, 1);
+    EXPECT_EQ(pool.stats().deferred_blocks, 0u);
+    pool.deallocate(odd, 17, 1);
+    {
+        std::vector<std::pmr::string> strings;
+        for (int i = 0; i < 300; ++i) strings.emplace_back(17 + i % 50, 'x', &pool);
+        for (std::size_t i = 0; i < strings.size(); i += 2) strings[i] = std::pmr::string(&pool);
+    }
+    EXPECT_LE(pool.stats().deferred_blocks, 64u);
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().chunks, 1u);
+    EXPECT_EQ(pool.stats().used_bytes, 0u);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+#include <new>
+#include <vector>
+
+TEST(StaticVectorBlocksFrames, BumpAllocationAndRelease) {
+    StaticVectorBlocks pool(256 * 1024);
+    void* before = pool.allocate(100);
+    StaticVectorBlocks::Stats s0 = pool.stats();
+
+    StaticVectorBlocks::Mark m = pool.mark();
+    auto* a = static_cast<char*>(pool.allocate(32));
+    auto* b = static_cast<char*>(pool.allocate(48));
+    auto* c = static_cast<char*>(pool.allocate(64, 64));
+    EXPECT_EQ(b, a + 32);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c) % 64, 0u);
+    EXPECT_EQ(pool.frame_depth(), 1u);
+
+    // Освобождение в кадре таблицу не трогает; последний блок откатывает вершину.
+    pool.deallocate(c, 64, 64);
+    EXPECT_EQ(pool.allocate(16), c);
+
+    // Блок, выделенный до кадра, освобождается как обычно.
+    pool.deallocate(before, 100);
+
+    pool.release_to(m);
+    EXPECT_EQ(pool.frame_depth(), 0u);
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.free_bytes, s0.free_bytes + s0.used_bytes);
+}
+
+TEST(StaticVectorBlocksFrames, NestedFramesAcrossRegions) {
+    StaticVectorBlocks::Options opts;
+    opts.frame_region = 1024;
+    StaticVectorBlocks pool(256 * 1024, opts);
+
+    StaticVectorBlocks::Mark outer = pool.mark();
+    std::vector<void*> kept;
+    for (int i = 0; i < 30; ++i) kept.push_back(pool.allocate(100));
+    std::size_t used = pool.stats().used_bytes;
+
+    StaticVectorBlocks::Mark inner = pool.mark();
+    for (int i = 0; i < 50; ++i) (void)pool.allocate(100);
+    void* big = pool.allocate(5000);
+    EXPECT_NE(big, nullptr);
+    pool.release_to(inner);
+
+    // Регионы внутреннего кадра вернулись в таблицу, внешний цел.
+    EXPECT_EQ(pool.frame_depth(), 1u);
+    EXPECT_EQ(pool.stats().used_bytes, used);
+    EXPECT_EQ(pool.allocate(100), static_cast<char*>(kept.back()) + 112);
+
+    pool.release_to(outer);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksFrames, QueuesWithSkippedDestructors) {
+    StaticVectorBlocks pool(1 << 20);
+    std::size_t free_before = pool.stats().free_bytes;
+
+    StaticVectorBlocks::Mark m = pool.mark();
+    std::vector<PmrQueue<int>*> queues;
+    for (int q = 0; q < 20; ++q) {
+        void* mem = pool.allocate(sizeof(PmrQueue<int>), alignof(PmrQueue<int>));
+        queues.push_back(::new (mem) PmrQueue<int>(4, &pool));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        queues[i % queues.size()]->push(i);
+    }
+    EXPECT_EQ(queues[3]->front(), 3);
+
+    // Деструкторы очередей не вызываются: память уходит целиком.
+    pool.release_to(m);
+    EXPECT_EQ(pool.stats().free_bytes, free_before);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+
+    // Очередь, пережившая свой кадр, после abandon() уничтожается безопасно.
+    PmrQueue<int> survivor(8, &pool);
+    {
+        StaticVectorBlocks::Mark inner = pool.mark();
+        PmrQueue<int> scratch(8, &pool);
+        for (int i = 0; i < 100; ++i) scratch.push(i);
+        pool.release_to(inner);
+        scratch.abandon();
+    }
+    survivor.push(1);
+    EXPECT_EQ(survivor.front(), 1);
+}
+
+TEST(StaticVectorBlocksFrames, ResetDropsEverything) {
+    StaticVectorBlocks::Options opts;
+    opts.deferred_limit = 16;
+    StaticVectorBlocks pool(64 * 1024, opts);
+    for (int i = 0; i < 100; ++i) (void)pool.allocate(64);
+    pool.deallocate(pool.allocate(64), 64);
+    (void)pool.mark();
+    (void)pool.allocate(200);
+
+    pool.reset();
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.free_bytes, 64u * 1024);
+    EXPECT_EQ(s.deferred_blocks, 0u);
+    EXPECT_EQ(pool.frame_depth(), 0u);
+    EXPECT_NE(pool.allocate(64 * 1024), nullptr);
+}
+
+TEST(StaticVectorBlocksFrames, StaleFramePointerIsRejected) {
+    StaticVectorBlocks pool(256 * 1024);
+    StaticVectorBlocks::Mark m = pool.mark();
+    void* first = pool.allocate(64);
+    void* second = pool.allocate(64);
+    pool.release_to(m);
+    StaticVectorBlocks::Stats s = pool.stats();
+
+    // Владелец, не забывший память кадра, возвращает её после отката: пул это отбрасывает.
+    EXPECT_DEBUG_DEATH(pool.deallocate(second, 64), "");
+    EXPECT_DEBUG_DEATH(pool.deallocate(first, 64), "");
+    EXPECT_EQ(pool.stats().chunks, s.chunks);
+    EXPECT_EQ(pool.stats().free_bytes, s.free_bytes);
+
+    // Память отброшенного региона выдана снова — указатели в неё законны.
+    void* again = pool.allocate(64);
+    EXPECT_EQ(again, first);
+    pool.deallocate(again, 64);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+#include <string>
+#include <string_view>
+
+TEST(StaticVectorBlocksInPlace, ExpandIntoFreeNeighbour) {
+    StaticVectorBlocks pool(4096);
+    void* a = pool.allocate(256);
+    void* b = pool.allocate(256);
+    pool.deallocate(b, 256);
+
+    EXPECT_TRUE(pool.try_expand(a, 256, 400));
+    EXPECT_TRUE(pool.try_expand(a, 400, 4096));
+    EXPECT_FALSE(pool.try_expand(a, 4096, 4097));
+    EXPECT_EQ(pool.stats().chunks, 1u);
+
+    EXPECT_TRUE(pool.shrink_in_place(a, 4096, 128));
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.used_bytes, 128u);
+    EXPECT_EQ(s.largest_free, 4096u - 128);
+    pool.deallocate(a, 128);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksInPlace, BlockedByUsedNeighbour) {
+    StaticVectorBlocks pool(4096, StaticVectorBlocks::Placement::BestFit);
+    void* a = pool.allocate(256);
+    void* b = pool.allocate(256);
+    EXPECT_FALSE(pool.try_expand(a, 256, 300));
+
+    // Хвост сжатого блока — новый свободный кусок, и он попадает в индекс BestFit.
+    EXPECT_TRUE(pool.shrink_in_place(a, 256, 64));
+    EXPECT_EQ(pool.allocate(192), static_cast<char*>(a) + 64);
+    EXPECT_TRUE(pool.try_expand(b, 256, 1024));
+    EXPECT_EQ(pool.stats().chunks, 4u);
+}
+
+TEST(PmrQueueInPlace, GrowsWithoutMovingBuffer) {
+    StaticVectorBlocks pool(64 * 1024);
+    PmrQueue<int> q(4, &pool);
+    for (int i = 0; i < 4; ++i) q.push(i);
+    const int* first = &q.front();
+
+    for (int i = 4; i < 1000; ++i) q.push(i);
+    EXPECT_EQ(&q.front(), first);
+    EXPECT_EQ(pool.stats().used_bytes, q.capacity() * sizeof(int));
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+}
+
+TEST(PmrQueueInPlace, WrappedRingKeepsOrder) {
+    StaticVectorBlocks pool(64 * 1024);
+    PmrQueue<std::pmr::string> q(8, &pool);
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 6; ++round) {
+        for (int i = 0; i < 3; ++i) q.emplace(std::to_string(next_in++));
+        for (int i = 0; i < 2; ++i) {
+            EXPECT_EQ(std::string_view(q.front()), std::to_string(next_out++));
+            q.pop();
+        }
+    }
+    // Кольцо закручено; рост должен сохранить порядок, какую бы часть он ни переносил.
+    for (int i = 0; i < 40; ++i) q.emplace(std::to_string(next_in++));
+    EXPECT_EQ(pool.stats().used_bytes, q.capacity() * sizeof(std::pmr::string));
+    while (!q.empty()) {
+        EXPECT_EQ(std::string_view(q.front()), std::to_string(next_out++));
+        q.pop();
+    }
+    EXPECT_EQ(next_out, next_in);
+}
+
+TEST(PmrQueueInPlace, ShortTailSegmentIsMovedToTheEnd) {
+    StaticVectorBlocks pool(64 * 1024);
+    PmrQueue<std::pmr::string> q(8, &pool);
+    for (int i = 0; i < 8; ++i) q.emplace(std::to_string(i));
+    for (int i = 0; i < 7; ++i) q.pop();
+    for (int i = 8; i < 15; ++i) q.emplace(std::to_string(i));
+
+    // head_ == 7: дешевле перенести один элемент в конец нового буфера, чем семь.
+    q.emplace("15");
+    EXPECT_EQ(q.capacity(), 16u);
+    EXPECT_EQ(pool.stats().used_bytes, 16 * sizeof(std::pmr::string));
+    for (int i = 7; i < 16; ++i) {
+        EXPECT_EQ(std::string_view(q.front()), std::to_string(i));
+        q.pop();
+    }
+}
+
+TEST(PmrQueueInPlace, ShrinkToFitReturnsTail) {
+    StaticVectorBlocks pool(64 * 1024);
+    PmrQueue<long> q(1024, &pool);
+    for (long i = 0; i < 10; ++i) q.push(i);
+    const long* first = &q.front();
+
+    q.shrink_to_fit();
+    EXPECT_EQ(q.capacity(), 10u);
+    EXPECT_EQ(&q.front(), first);
+    EXPECT_EQ(pool.stats().used_bytes, 10 * sizeof(long));
+    for (long i = 0; i < 10; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+}
+
+TEST(StaticVectorBlocksAtLeast, AbsorbsSliverSuffix) {
+    StaticVectorBlocks pool(4096 + 20);
+    SizedAllocation a = pool.allocate_at_least(4096, 16);
+    EXPECT_EQ(a.bytes, 4096u + 20);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+    pool.deallocate(a.ptr, 4096);
+
+    // Обычный allocate по-прежнему отрезает ровно запрошенное.
+    void* p = pool.allocate(4096);
+    EXPECT_EQ(pool.stats().used_bytes, 4096u);
+    pool.deallocate(p, 4096);
+
+    SizedAllocation b = pool.allocate_at_least(1000, 16);
+    EXPECT_EQ(b.bytes, 1000u);
+    pool.deallocate(b.ptr, b.bytes);
+}
+
+TEST(PmrQueueAtLeast, CapacityTakesAllocatorSlack) {
+    StaticVectorBlocks pool(4096 + 20);
+    PmrQueue<int> q(1024, &pool);
+    EXPECT_EQ(q.capacity(), 1029u);
+    for (int i = 0; i < 1029; ++i) q.push(i);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+    for (int i = 0; i < 1029; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+}
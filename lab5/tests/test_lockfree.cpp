@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "lockfree_res.hpp"
+#include "mem_res.hpp"
+
+#include <atomic>
+#include <list>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST(LockFreeFixedBlocks, HandsOutEveryBlockOnce) {
+    StaticVectorBlocks source(64 * 1024);
+    {
+        LockFreeFixedBlocks pool(40, 8, &source);
+        EXPECT_EQ(pool.block_size(), 48u);
+        EXPECT_EQ(source.stats().used_bytes, 8u * 48);
+
+        std::set<void*> seen;
+        for (int i = 0; i < 8; ++i) seen.insert(pool.allocate(40));
+        EXPECT_EQ(seen.size(), 8u);
+        EXPECT_THROW((void)pool.allocate(40), std::bad_alloc);
+
+        void* p = *seen.begin();
+        pool.deallocate(p, 40);
+        EXPECT_EQ(pool.allocate(40), p);
+        EXPECT_THROW((void)pool.allocate(100), std::bad_alloc);
+        for (void* q : seen) pool.deallocate(q, 40);
+    }
+    EXPECT_EQ(source.stats().used_bytes, 0u);
+}
+
+TEST(LockFreeFixedBlocks, NodeContainer) {
+    LockFreeFixedBlocks pool(64, 1000);
+    std::pmr::list<long> nodes(&pool);
+    for (long i = 0; i < 1000; ++i) nodes.push_back(i);
+    EXPECT_THROW(nodes.push_back(0), std::bad_alloc);
+    nodes.remove_if([](long v) { return v % 2; });
+    for (long i = 0; i < 500; ++i) nodes.push_front(-i);
+    EXPECT_EQ(nodes.size(), 1000u);
+}
+
+TEST(LockFreeFixedBlocks, ConcurrentChurnNeverSharesABlock) {
+    constexpr std::size_t kCapacity = 64;
+    LockFreeFixedBlocks pool(sizeof(std::uint64_t), kCapacity);
+    std::atomic<bool> broken{false};
+
+    std::vector<std::thread> threads;
+    for (std::uint64_t t = 1; t <= 4; ++t) {
+        threads.emplace_back([&pool, &broken, t] {
+            std::vector<std::uint64_t*> held;
+            for (std::uint64_t i = 0; i < 100000; ++i) {
+                if (held.size() < 8) {
+                    auto* p = static_cast<std::uint64_t*>(pool.allocate(sizeof(std::uint64_t)));
+                    *p = t << 32 | i;
+                    held.push_back(p);
+                } else {
+                    // Блок, выданный дважды, был бы перезаписан чужим потоком.
+                    for (auto* p : held) {
+                        if (*p >> 32 != t) broken = true;
+                        pool.deallocate(p, sizeof(std::uint64_t));
+                    }
+                    held.clear();
+                }
+            }
+            for (auto* p : held) pool.deallocate(p, sizeof(std::uint64_t));
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_FALSE(broken);
+
+    // Ни один блок не потерян.
+    std::vector<void*> all;
+    for (std::size_t i = 0; i < kCapacity; ++i) all.push_back(pool.allocate(8));
+    EXPECT_THROW((void)pool.allocate(8), std::bad_alloc);
+    for (void* p : all) pool.deallocate(p, 8);
+}
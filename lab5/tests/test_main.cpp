@@ -4,10 +4,18 @@
 #include "queue.hpp"  
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <iterator>
 #include <type_traits>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <span>
+#include <random>
 
 TEST(PmrQueueBasicInt, PushPopAndOrder) {
     StaticVectorBlocks pool(64 * 1024);
@@ -144,6 +152,360 @@ TEST(PmrQueueExhaustion, SmallPoolThrowsBadAlloc) {
     }, std::bad_alloc);
 }
 
+class CountingResource: public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Подменяет ресурс по умолчанию, пока жив; прежний возвращается и при провале проверки.
+struct DefaultResource {
+    explicit DefaultResource(std::pmr::memory_resource* r) : prev(std::pmr::set_default_resource(r)) {}
+    ~DefaultResource() { std::pmr::set_default_resource(prev); }
+    std::pmr::memory_resource* prev;
+};
+
+namespace {
+
+// Вызовы глобальных operator new / operator delete во всём тестовом бинарнике:
+// служебные структуры пула, сделанные на std::vector, шли бы мимо pmr прямо сюда.
+std::atomic<std::size_t> global_news{0};
+std::atomic<std::size_t> global_deletes{0};
+
+// Сколько раз глобальная куча была затронута за время жизни объекта.
+struct GlobalHeapCalls {
+    std::size_t news0 = global_news.load();
+    std::size_t deletes0 = global_deletes.load();
+    std::size_t news() const { return global_news.load() - news0; }
+    std::size_t deletes() const { return global_deletes.load() - deletes0; }
+};
+
+void* counted_new(std::size_t n, std::size_t align) {
+    ++global_news;
+    // Перед выровненным блоком хранится указатель, полученный от malloc.
+    void* raw = std::malloc(n + align + sizeof(void*));
+    if (!raw) {
+        throw std::bad_alloc();
+    }
+    auto p = (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*) + align - 1) & ~(align - 1);
+    reinterpret_cast<void**>(p)[-1] = raw;
+    return reinterpret_cast<void*>(p);
+}
+
+void counted_delete(void* p) noexcept {
+    if (p) {
+        ++global_deletes;
+        std::free(static_cast<void**>(p)[-1]);
+    }
+}
+
+}  // namespace
+
+void* operator new(std::size_t n) { return counted_new(n, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t n, std::align_val_t a) {
+    return counted_new(n, std::max(static_cast<std::size_t>(a), std::size_t(__STDCPP_DEFAULT_NEW_ALIGNMENT__)));
+}
+void operator delete(void* p) noexcept { counted_delete(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_delete(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_delete(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_delete(p); }
+
+TEST(StaticVectorBlocksHeap, AllocationsDoNotEscapePool) {
+    CountingResource counting;
+    DefaultResource guard(&counting);
+    StaticVectorBlocks pool(64 * 1024);
+    counting.allocations = 0;
+    GlobalHeapCalls heap;
+    {
+        PmrQueue<std::pmr::string> q(2, &pool);
+        char text[64];
+        for (int i = 0; i < 20; ++i) {
+            std::snprintf(text, sizeof(text), "%d_string_too_long_for_sso", i);
+            q.emplace(text);
+        }
+        while (!q.empty()) q.pop();
+    }
+    std::size_t news = heap.news();
+    std::size_t deletes = heap.deletes();
+    EXPECT_EQ(counting.allocations, 0u);
+    EXPECT_EQ(news, 0u);
+    EXPECT_EQ(deletes, 0u);
+}
+
+TEST(StaticVectorBlocksHeap, TableGrowthPastReserveFailsWithoutHeap) {
+    // Пул поверх storage без ресурса по умолчанию: таблица блоков, переросшая запас
+    // metadata_reserve, не может взять память и выделение отказывает (nullptr у
+    // try_allocate, std::bad_alloc у allocate) — в глобальную кучу пул не идёт.
+    alignas(16) static std::byte storage[64 * 1024];
+    DefaultResource no_heap(std::pmr::null_memory_resource());
+    StaticVectorBlocks pool{std::span<std::byte>(storage), StaticVectorBlocks::Options()};
+    GlobalHeapCalls heap;
+
+    std::vector<void*> blocks;
+    blocks.reserve(1024);
+    std::size_t before = heap.news();
+    while (void* p = pool.try_allocate(32)) {
+        blocks.push_back(p);
+    }
+    bool threw = false;
+    try {
+        (void)pool.allocate(32);
+    } catch (const std::bad_alloc&) {
+        threw = true;
+    }
+    std::size_t news = heap.news() - before;
+
+    EXPECT_TRUE(threw);
+    EXPECT_EQ(news, 0u);
+    EXPECT_GT(blocks.size(), 64u);
+    // Место в storage ещё есть: отказ вызван именно таблицей.
+    EXPECT_GT(pool.stats().free_bytes, 32u);
+    EXPECT_EQ(pool.stats().used_bytes, blocks.size() * 32);
+
+    for (void* p : blocks) pool.deallocate(p, 32);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+using Placement = StaticVectorBlocks::Placement;
+
+TEST(StaticVectorBlocksPlacement, BestFitPicksSmallestHole) {
+    auto holes = [](Placement policy) {
+        StaticVectorBlocks pool(4096, policy);
+        void* big = pool.allocate(320);
+        void* sep1 = pool.allocate(16);
+        void* small = pool.allocate(96);
+        void* sep2 = pool.allocate(16);
+        pool.deallocate(big, 320);
+        pool.deallocate(small, 96);
+
+        void* p = pool.allocate(80);
+        bool took_small = p == small;
+        EXPECT_TRUE(p == small || p == big);
+        pool.deallocate(p, 80);
+        pool.deallocate(sep1, 16);
+        pool.deallocate(sep2, 16);
+        return took_small;
+    };
+
+    EXPECT_FALSE(holes(Placement::FirstFit));
+    EXPECT_FALSE(holes(Placement::AddressOrdered));
+    EXPECT_TRUE(holes(Placement::BestFit));
+}
+
+TEST(StaticVectorBlocksPlacement, NextFitContinuesFromRover) {
+    StaticVectorBlocks pool(4096, Placement::NextFit);
+    void* a = pool.allocate(64);
+    void* b = pool.allocate(64);
+    pool.deallocate(a, 64);
+
+    // Дыра в начале пула есть, но next-fit продолжает с места последнего выделения.
+    void* c = pool.allocate(64);
+    EXPECT_GT(c, b);
+    pool.deallocate(b, 64);
+    pool.deallocate(c, 64);
+}
+
+TEST(StaticVectorBlocksPlacement, EveryPolicyCoalescesAfterChurn) {
+    for (Placement policy : {Placement::FirstFit, Placement::NextFit,
+                             Placement::BestFit, Placement::AddressOrdered}) {
+        StaticVectorBlocks pool(256 * 1024, policy);
+        {
+            std::vector<PmrQueue<int>> queues;
+            for (int i = 0; i < 6; ++i) queues.emplace_back(2, &pool);
+            std::vector<std::pmr::string> strings;
+            for (int step = 0; step < 3000; ++step) {
+                queues[step % queues.size()].push(step);
+                if (step % 3 == 0) strings.emplace_back(20 + step % 90, 'x', &pool);
+                if (step % 5 == 0 && !strings.empty()) strings.erase(strings.begin() + step % strings.size());
+                if (step % 7 == 0) queues[step % queues.size()].pop();
+            }
+        }
+        StaticVectorBlocks::Stats s = pool.stats();
+        EXPECT_EQ(s.chunks, 1u);
+        EXPECT_EQ(s.free_bytes, 256u * 1024);
+    }
+}
+
+TEST(StaticVectorBlocksTable, FirstFitAcrossManyChunks) {
+    // Сотни записей: поиск и сдвиги битового набора free пересекают границы слов.
+    StaticVectorBlocks pool(300 * 32);
+    std::vector<void*> blocks;
+    for (int i = 0; i < 300; ++i) blocks.push_back(pool.allocate(32, 16));
+
+    std::vector<int> holes;
+    for (int i = 0; i < 300; i += 3) {
+        pool.deallocate(blocks[i], 32, 16);
+        holes.push_back(i);
+    }
+    for (int h : holes) {
+        auto* base = static_cast<char*>(blocks[h]);
+        EXPECT_EQ(pool.allocate(16, 16), base);
+        EXPECT_EQ(pool.allocate(16, 16), base + 16);
+    }
+    EXPECT_THROW((void)pool.allocate(16, 16), std::bad_alloc);
+
+    for (int h : holes) {
+        auto* base = static_cast<char*>(blocks[h]);
+        pool.deallocate(base + 16, 16, 16);
+        pool.deallocate(base, 16, 16);
+    }
+    for (int i = 0; i < 300; ++i) {
+        if (i % 3) pool.deallocate(blocks[i], 32, 16);
+    }
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+// Сборка с -DLAB5_AVX2=ON обязана проходить по векторным ветвям поиска.
+#if defined(LAB5_AVX2) && !defined(__AVX2__)
+#error "LAB5_AVX2 задан, но компилятор собирает без AVX2"
+#endif
+
+TEST(StaticVectorBlocksTable, FindFreeMatchesPlainScan) {
+    // Маска размеров считается пачками по 4 записи (AVX2) и хвостом по одной —
+    // сверяем её с прямым перебором на таблице, длина которой не кратна ни 4, ни 64.
+    std::mt19937 rng(7);
+    ChunkTable t;
+    std::size_t off = 0;
+    for (int i = 0; i < 203; ++i) {
+        std::size_t sz = 16 * (1 + rng() % 64);
+        t.push_back({off, sz, rng() % 3 != 0});
+        off += sz;
+    }
+    for (std::size_t min_sz : {1u, 16u, 200u, 512u, 1000u, 1024u, 2000u}) {
+        for (std::size_t from : {0u, 3u, 63u, 64u, 130u, 202u}) {
+            std::size_t expect = ChunkTable::npos;
+            for (std::size_t i = from; i < t.size(); ++i) {
+                if (t.is_free(i) && t.sz(i) >= min_sz) {
+                    expect = i;
+                    break;
+                }
+            }
+            EXPECT_EQ(t.find_free(from, min_sz, [](std::size_t) { return true; }), expect)
+                << "min_sz " << min_sz << ", from " << from;
+        }
+    }
+}
+
+TEST(StaticVectorBlocksGrowth, SpillsToUpstreamInsteadOfBadAlloc) {
+    CountingResource upstream;
+    StaticVectorBlocks pool(1024, Placement::FirstFit, &upstream, 2.0);
+    {
+        PmrQueue<int> q(4, &pool);
+        for (int i = 0; i < 2000; ++i) q.push(i);
+        for (int i = 0; i < 2000; ++i) {
+            EXPECT_EQ(q.front(), i);
+            q.pop();
+        }
+
+        StaticVectorBlocks::Stats s = pool.stats();
+        EXPECT_GT(s.spills, 0u);
+        EXPECT_EQ(s.arenas, s.spills + 1);
+        EXPECT_GT(s.spilled_allocations, 0u);
+        EXPECT_EQ(upstream.allocations, s.spills);
+    }
+    // Арены остаются за пулом, но всё в них снова свободно.
+    EXPECT_EQ(pool.stats().used_bytes, 0u);
+}
+
+TEST(StaticVectorBlocksGrowth, OversizedRequestGetsItsOwnArena) {
+    StaticVectorBlocks pool(256, Placement::BestFit, std::pmr::new_delete_resource(), 1.5);
+    void* small = pool.allocate(100);
+    void* big = pool.allocate(10000, 64);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(big) % 64, 0u);
+    EXPECT_EQ(pool.stats().arenas, 2u);
+
+    pool.deallocate(big, 10000, 64);
+    pool.deallocate(small, 100);
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.used_bytes, 0u);
+    EXPECT_EQ(s.chunks, 2u);  // по одному свободному блоку на арену
+}
+
+TEST(StaticVectorBlocksMmap, QueueOnMappedPool) {
+    StaticVectorBlocks::Options opts;
+    opts.backing = StaticVectorBlocks::Backing::Mmap;
+    opts.map.huge_pages = true;
+    opts.map.hugetlb = true;  // без настроенных hugetlbfs-страниц откатывается к обычным
+    opts.map.populate = true;
+    StaticVectorBlocks pool(4 << 20, opts);
+
+    PmrQueue<std::pmr::string> q(2, &pool);
+    for (int i = 0; i < 1000; ++i) q.emplace(std::to_string(i) + "_string_too_long_for_sso");
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(std::string_view(q.front()), std::to_string(i) + "_string_too_long_for_sso");
+        q.pop();
+    }
+}
+
+TEST(StaticVectorBlocksMmap, ReleasedRangeStaysUsable) {
+    StaticVectorBlocks::Options opts;
+    opts.backing = StaticVectorBlocks::Backing::Mmap;
+    opts.release_threshold = 64 * 1024;
+    StaticVectorBlocks pool(1 << 20, opts);
+
+    auto* head = static_cast<unsigned char*>(pool.allocate(256 * 1024));
+    auto* tail = static_cast<unsigned char*>(pool.allocate(4096));
+    std::fill(head, head + 256 * 1024, 0xAB);
+    pool.deallocate(head, 256 * 1024);
+
+    // Страницы освобождённого блока отданы ОС и при следующем касании приходят заново.
+    auto* again = static_cast<unsigned char*>(pool.allocate(256 * 1024));
+    EXPECT_EQ(again, head);
+#if LAB5_HAS_MMAP
+    EXPECT_EQ(again[128 * 1024], 0);
+#endif
+    std::fill(again, again + 256 * 1024, 0xCD);
+    EXPECT_EQ(again[256 * 1024 - 1], 0xCD);
+
+    pool.deallocate(again, 256 * 1024);
+    pool.deallocate(tail, 4096);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksMmap, ShrunkTailAndBatchRunsAreReleased) {
+    StaticVectorBlocks::Options opts;
+    opts.backing = StaticVectorBlocks::Backing::Mmap;
+    opts.release_threshold = 64 * 1024;
+    StaticVectorBlocks pool(1 << 20, opts);
+
+    // Хвост, отрезанный shrink_in_place, отдаётся ОС сразу.
+    auto* head = static_cast<unsigned char*>(pool.allocate(256 * 1024));
+    void* guard = pool.allocate(4096);
+    std::fill(head, head + 256 * 1024, 0xAB);
+    ASSERT_TRUE(pool.shrink_in_place(head, 256 * 1024, 4096));
+    ASSERT_TRUE(pool.try_expand(head, 4096, 256 * 1024));
+#if LAB5_HAS_MMAP
+    EXPECT_EQ(head[128 * 1024], 0);
+#endif
+    pool.deallocate(head, 256 * 1024);
+
+    // Мелкие блоки, слитые пачкой в кусок не меньше порога, — тоже.
+    void* blocks[4];
+    pool.allocate_batch(4, 32 * 1024, alignof(std::max_align_t), blocks);
+    for (void* p : blocks) std::fill_n(static_cast<unsigned char*>(p), 32 * 1024, 0xAB);
+    void* fence = pool.allocate(4096);
+    pool.deallocate_batch(blocks);
+    auto* again = static_cast<unsigned char*>(pool.allocate(128 * 1024));
+#if LAB5_HAS_MMAP
+    EXPECT_EQ(again[64 * 1024], 0);
+#endif
+    pool.deallocate(again, 128 * 1024);
+    pool.deallocate(fence, 4096);
+    pool.deallocate(guard, 4096);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
 static_assert(std::is_same_v<typename PmrQueue<int>::iterator::iterator_category, std::forward_iterator_tag>,
               "iterator must be forward_iterator_tag");
 
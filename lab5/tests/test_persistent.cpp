@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "file_res.hpp"
+#include "offset_queue.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Message {
+    std::uint64_t id;
+    double value;
+    char tag[8];
+};
+
+// Путь во временном каталоге; файл удаляется до и после теста.
+struct TempFile {
+    explicit TempFile(const char* name) : path(testing::TempDir() + name) { std::remove(path.c_str()); }
+    ~TempFile() { std::remove(path.c_str()); }
+    std::string path;
+};
+
+}  // namespace
+
+TEST(FileStaticVectorBlocks, QueueSurvivesReopen) {
+#if !LAB5_HAS_MMAP
+    GTEST_SKIP() << "нет mmap: файловый пул не поддерживается";
+#endif
+    TempFile file("lab5_persistent_queue.pool");
+    {
+        FileStaticVectorBlocks pool(file.path.c_str(), 1 << 20);
+        EXPECT_FALSE(pool.restored());
+        auto q = OffsetQueue<Message>::at_root(pool, 0, 4);
+        for (std::uint64_t i = 0; i < 1000; ++i) q.push({i, i * 0.5, "msg"});
+        for (int i = 0; i < 10; ++i) q.pop();
+    }
+    {
+        FileStaticVectorBlocks pool(file.path.c_str(), 1 << 20);
+        EXPECT_TRUE(pool.restored());
+        auto q = OffsetQueue<Message>::at_root(pool, 0);
+        ASSERT_EQ(q.size(), 990u);
+        EXPECT_EQ(q.front().id, 10u);
+        EXPECT_EQ(q.back().value, 999 * 0.5);
+        EXPECT_STREQ(q[500].tag, "msg");
+
+        // Работа продолжается с того же места; освобождение после перезапуска сливает блоки.
+        q.push({1000, 0, "new"});
+        EXPECT_EQ(q.back().id, 1000u);
+        q.destroy();
+        pool.set_root(0, 0);
+        EXPECT_EQ(pool.stats().chunks, 1u);
+    }
+}
+
+TEST(FileStaticVectorBlocks, TwoMappingsAtDifferentAddresses) {
+#if !LAB5_HAS_MMAP
+    GTEST_SKIP() << "нет mmap: файловый пул не поддерживается";
+#endif
+    TempFile file("lab5_persistent_twice.pool");
+    FileStaticVectorBlocks writer(file.path.c_str(), 256 * 1024);
+    FileStaticVectorBlocks reader(file.path.c_str(), 256 * 1024);
+    ASSERT_NE(writer.base(), reader.base());
+
+    auto q = OffsetQueue<std::uint32_t>::at_root(writer, 3);
+    for (std::uint32_t i = 0; i < 100; ++i) q.push(i * i);
+
+    auto view = OffsetQueue<std::uint32_t>::at_root(reader, 3);
+    EXPECT_EQ(view.offset(), q.offset());
+    ASSERT_EQ(view.size(), 100u);
+    EXPECT_EQ(view[9], 81u);
+    EXPECT_EQ(reader.stats().used_bytes, writer.stats().used_bytes);
+}
+
+TEST(FileStaticVectorBlocks, ForeignFileIsNotOverwritten) {
+#if !LAB5_HAS_MMAP
+    GTEST_SKIP() << "нет mmap: файловый пул не поддерживается";
+#endif
+    TempFile file("lab5_persistent_foreign.pool");
+    {
+        std::ofstream out(file.path);
+        out << "не пул";
+    }
+    EXPECT_THROW(FileStaticVectorBlocks(file.path.c_str(), 1 << 20), std::runtime_error);
+    std::ifstream in(file.path);
+    std::string text;
+    std::getline(in, text);
+    EXPECT_EQ(text, "не пул");
+}
+
+TEST(FileStaticVectorBlocks, TableCapacityAndAlignment) {
+#if !LAB5_HAS_MMAP
+    GTEST_SKIP() << "нет mmap: файловый пул не поддерживается";
+#endif
+    TempFile file("lab5_persistent_table.pool");
+    FileStaticVectorBlocks pool(file.path.c_str(), 1 << 20, 8);
+    void* page = pool.allocate(100, 4096);
+    EXPECT_EQ(pool.offset_of(page) % 4096, 0u);
+
+    // Восемь записей: после нескольких блоков с выравниванием таблица заполняется.
+    std::vector<void*> blocks;
+    EXPECT_THROW(
+        for (int i = 0; i < 8; ++i) blocks.push_back(pool.allocate(10, 4096)),
+        std::bad_alloc);
+    for (void* p : blocks) pool.deallocate(p, 10, 4096);
+    pool.deallocate(page, 100, 4096);
+    RegionBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.chunks, 1u);
+    EXPECT_EQ(s.free_bytes, pool.region_size() - RegionBlocks::metadata_size(8));
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include "boundary_tag_res.hpp"
+#include "buddy_res.hpp"
+#include "mem_res.hpp"
+#include "queue.hpp"
+#include "slab_res.hpp"
+#include "tlsf_res.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Общие проверки для ресурсов с одинаковым конструктором от размера пула;
+// проверки, специфичные для ресурса, — в его собственном файле.
+
+namespace {
+
+// Ресурс на size байт.
+template <typename R>
+struct Pool {
+    explicit Pool(std::size_t size) : res(size) {}
+    R res;
+};
+
+// SlabBlocks берёт страницы у StaticVectorBlocks того же размера.
+template <>
+struct Pool<SlabBlocks> {
+    explicit Pool(std::size_t size) : backing(size), res(&backing, 4096) {}
+    StaticVectorBlocks backing;
+    SlabBlocks res;
+};
+
+}  // namespace
+
+template <typename R>
+class PoolResource: public testing::Test {};
+
+using PoolResources = testing::Types<BoundaryTagBlocks, TlsfBlocks, BuddyBlocks, SlabBlocks>;
+TYPED_TEST_SUITE(PoolResource, PoolResources);
+
+TYPED_TEST(PoolResource, QueueGrowthPreservesOrder) {
+    Pool<TypeParam> pool(128 * 1024);
+    PmrQueue<int> q(2, &pool.res);
+
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(q.front(), i);
+        q.pop();
+    }
+    EXPECT_TRUE(q.empty());
+}
+
+TYPED_TEST(PoolResource, QueueOfPmrStrings) {
+    Pool<TypeParam> pool(256 * 1024);
+    PmrQueue<std::pmr::string> q(2, &pool.res);
+
+    for (int i = 0; i < 200; ++i) {
+        q.emplace("payload_number_" + std::to_string(i) + "_long_enough_to_skip_sso");
+    }
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(std::string_view(q.front()), "payload_number_" + std::to_string(i) + "_long_enough_to_skip_sso");
+        q.pop();
+    }
+    EXPECT_TRUE(q.empty());
+}
+
+TYPED_TEST(PoolResource, RespectsOverAlignment) {
+    Pool<TypeParam> pool(64 * 1024);
+
+    std::vector<std::pair<void*, std::size_t>> blocks;
+    for (std::size_t align : {16u, 64u, 256u, 1024u}) {
+        void* p = pool.res.allocate(40, align);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+        blocks.push_back({p, align});
+    }
+    for (auto [p, align] : blocks) {
+        pool.res.deallocate(p, 40, align);
+    }
+    // Сверхвыровненные блоки вернулись в пул целиком.
+    EXPECT_NO_THROW(pool.res.deallocate(pool.res.allocate(32 * 1024), 32 * 1024));
+}
+
+TYPED_TEST(PoolResource, SmallPoolThrowsBadAlloc) {
+    Pool<TypeParam> tiny(16);
+
+    EXPECT_THROW({ PmrQueue<int> q(8, &tiny.res); }, std::bad_alloc);
+}
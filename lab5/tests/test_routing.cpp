@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "queue.hpp"
+#include "routing_res.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using Route = RoutingBlocks::Route;
+
+TEST(RoutingBlocks, RoutesBySizeAndAlignment) {
+    RoutingBlocks pool(1 << 20, 64 * 1024);
+    EXPECT_EQ(pool.route_of(24, 8), Route::Small);
+    EXPECT_EQ(pool.route_of(24, 64), Route::Medium);
+    EXPECT_EQ(pool.route_of(4096, 16), Route::Medium);
+    EXPECT_EQ(pool.route_of(64 * 1024, 16), Route::Huge);
+
+    void* a = pool.allocate(24);
+    void* b = pool.allocate(4096);
+    void* c = pool.allocate(100 * 1024);
+    EXPECT_EQ(pool.stats(Route::Small).allocations, 1u);
+    EXPECT_EQ(pool.stats(Route::Medium).bytes_in_use, 4096u);
+    EXPECT_EQ(pool.stats(Route::Huge).bytes_in_use, 100u * 1024);
+    EXPECT_EQ(pool.slab_pages(), 1u);
+
+    pool.deallocate(c, 100 * 1024);
+    pool.deallocate(b, 4096);
+    pool.deallocate(a, 24);
+    for (Route r : {Route::Small, Route::Medium, Route::Huge}) {
+        EXPECT_EQ(pool.stats(r).allocations, pool.stats(r).deallocations);
+        EXPECT_EQ(pool.stats(r).bytes_in_use, 0u);
+    }
+    EXPECT_EQ(pool.stats(Route::Huge).peak_bytes, 100u * 1024);
+}
+
+TEST(RoutingBlocks, HugeRouteKeepsPageAlignment) {
+    RoutingBlocks pool(1 << 20, 64 * 1024);
+    for (std::size_t align : {std::size_t(64), osmem::page_size()}) {
+        ASSERT_EQ(pool.route_of(100 * 1024, align), Route::Huge);
+        void* p = pool.allocate(100 * 1024, align);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % align, 0u);
+        pool.deallocate(p, 100 * 1024, align);
+    }
+}
+
+TEST(RoutingBlocks, QueueBufferMovesToHugeRoute) {
+    RoutingBlocks pool(1 << 20, 256 * 1024);
+    {
+        PmrQueue<std::pmr::string> q(4, &pool);
+        for (int i = 0; i < 20000; ++i) q.emplace("element_with_heap_payload_" + std::to_string(i));
+        for (int i = 0; i < 20000; ++i) {
+            EXPECT_EQ(std::string_view(q.front()), "element_with_heap_payload_" + std::to_string(i));
+            q.pop();
+        }
+        // Строки — мелкие блоки, буфер очереди при росте ушёл в отдельные отображения.
+        EXPECT_GE(pool.stats(Route::Small).allocations, 20000u);
+        EXPECT_GT(pool.stats(Route::Medium).allocations, 0u);
+        EXPECT_GT(pool.stats(Route::Huge).allocations, 0u);
+        EXPECT_EQ(pool.stats(Route::Huge).allocations, pool.stats(Route::Huge).deallocations + 1);
+    }
+    EXPECT_EQ(pool.stats(Route::Huge).bytes_in_use, 0u);
+}
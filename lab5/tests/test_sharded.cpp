@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include "queue.hpp"
+#include "sharded_res.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(ShardedBlocks, ThreadsUseTheirOwnArena) {
+    ShardedBlocks pool(4 << 20, 4);
+    ASSERT_EQ(pool.shard_count(), 4u);
+
+    std::vector<void*> blocks(4);
+    std::vector<std::size_t> homes(4);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            homes[t] = pool.home_shard();
+            blocks[t] = pool.allocate(128);
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    for (int t = 0; t < 4; ++t) {
+        EXPECT_EQ(pool.shard_of(blocks[t]), homes[t]);
+    }
+    // Освобождение из другого потока возвращает блок его арене.
+    for (void* p : blocks) pool.deallocate(p, 128);
+    for (std::size_t k = 0; k < 4; ++k) {
+        EXPECT_EQ(pool.shard_stats(k).pool.used_bytes, 0u);
+    }
+}
+
+TEST(ShardedBlocks, ExhaustedArenaStealsFromNeighbours) {
+    ShardedBlocks pool(4 * 4096, 4);
+    std::size_t home = pool.home_shard();
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 6; ++i) blocks.push_back(pool.allocate(2048));
+    EXPECT_EQ(pool.shard_of(blocks[0]), home);
+    EXPECT_NE(pool.shard_of(blocks[5]), home);
+
+    std::size_t stolen = 0;
+    for (std::size_t k = 0; k < pool.shard_count(); ++k) stolen += pool.shard_stats(k).stolen;
+    EXPECT_EQ(stolen, 4u);
+
+    for (int i = 0; i < 8 - 6; ++i) blocks.push_back(pool.allocate(2048));
+    EXPECT_THROW((void)pool.allocate(2048), std::bad_alloc);
+    for (void* p : blocks) pool.deallocate(p, 2048);
+}
+
+TEST(ShardedBlocks, ForeignFreesGoThroughRemoteList) {
+    // Живые потоки имеют разные номера, и при 16 аренах их домашние арены различаются.
+    ShardedBlocks pool(1 << 20, 16);
+    std::size_t home = pool.home_shard();
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 100; ++i) blocks.push_back(pool.allocate(64));
+
+    // Освобождения из чужого потока не трогают таблицу арены до её следующего выделения.
+    std::thread consumer([&] {
+        ASSERT_NE(pool.home_shard(), home);
+        for (void* p : blocks) pool.deallocate(p, 64);
+    });
+    consumer.join();
+
+    void* again = pool.allocate(64);
+    EXPECT_EQ(again, blocks.front());
+    pool.deallocate(again, 64);
+
+    ShardedBlocks::ShardStats s = pool.shard_stats(home);
+    EXPECT_EQ(s.remote_frees, 100u);
+    EXPECT_EQ(s.drains, 1u);
+    EXPECT_EQ(s.pool.used_bytes, 0u);
+    EXPECT_EQ(s.pool.chunks, 1u);
+}
+
+TEST(ShardedBlocks, ConcurrentQueuesOnCpuSelection) {
+    ShardedBlocks pool(8 << 20, 0, ShardedBlocks::Select::Cpu);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, t] {
+            PmrQueue<std::pmr::string> q(2, &pool);
+            for (int i = 0; i < 3000; ++i) {
+                q.emplace(std::to_string(t) + "_payload_" + std::to_string(i));
+                if (i % 2 == 0) q.pop();
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    for (std::size_t k = 0; k < pool.shard_count(); ++k) {
+        EXPECT_EQ(pool.shard_stats(k).pool.used_bytes, 0u);
+    }
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include "offset_queue.hpp"
+#include "shared_res.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#if LAB5_HAS_SHARED_POOL
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Message {
+    std::uint64_t id;
+    std::uint64_t sender;
+};
+
+// Запустить body в дочернем процессе и вернуть его код выхода.
+// В потомке gtest не используется: результат передаётся только кодом.
+template <typename F>
+int in_child(F&& body) {
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        int code = 1;
+        try {
+            code = body();
+        } catch (...) {
+            code = 2;
+        }
+        ::_exit(code);
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+}  // namespace
+
+TEST(SharedStaticVectorBlocks, ChildPushesParentReads) {
+    SharedStaticVectorBlocks pool(1 << 20);
+    auto q = OffsetQueue<Message>::at_root(pool, 0, 4);
+    q.push({0, 0});
+
+    int code = in_child([&] {
+        // Отдельное отображение того же сегмента — по другому адресу.
+        SharedStaticVectorBlocks other(SharedStaticVectorBlocks::FromFd{::dup(pool.native_handle())});
+        if (other.base() == pool.base() || !other.restored()) return 3;
+        auto cq = OffsetQueue<Message>::at_root(other, 0);
+        std::lock_guard<SharedStaticVectorBlocks> guard(other);
+        for (std::uint64_t i = 1; i < 1000; ++i) cq.push({i, 1});
+        return 0;
+    });
+    ASSERT_EQ(code, 0);
+
+    ASSERT_EQ(q.size(), 1000u);
+    EXPECT_GE(q.capacity(), 1000u);
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        EXPECT_EQ(q.front().id, i);
+        q.pop();
+    }
+    q.destroy();
+    pool.set_root(0, 0);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(SharedStaticVectorBlocks, AllocationsFromBothProcessesDoNotOverlap) {
+    SharedStaticVectorBlocks pool(1 << 20);
+    void* mine = pool.allocate(256);
+
+    int code = in_child([&] {
+        void* theirs = pool.allocate(256);
+        pool.set_root(1, pool.offset_of(theirs));
+        return theirs == mine ? 3 : 0;
+    });
+    ASSERT_EQ(code, 0);
+
+    void* theirs = pool.at(pool.root(1));
+    ASSERT_NE(theirs, nullptr);
+    EXPECT_EQ(pool.stats().used_bytes, 512u);
+    pool.deallocate(theirs, 256);
+    pool.deallocate(mine, 256);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(SharedStaticVectorBlocks, RecoversMutexFromDeadOwner) {
+    SharedStaticVectorBlocks pool(1 << 20);
+    int code = in_child([&] {
+        pool.lock();
+        (void)pool.allocate(128);
+        return 0;  // выходит, не отпустив мьютекс
+    });
+    ASSERT_EQ(code, 0);
+
+    EXPECT_EQ(pool.owner_deaths(), 0u);
+    pool.lock();
+    EXPECT_EQ(pool.owner_deaths(), 1u);
+    EXPECT_TRUE(pool.consistent());
+    pool.unlock();
+
+    // Блок, выделенный умершим процессом, остался занят, а пул работает дальше.
+    EXPECT_EQ(pool.stats().used_bytes, 128u);
+    void* p = pool.allocate(64);
+    pool.deallocate(p, 64);
+}
+
+TEST(SharedStaticVectorBlocks, CorruptTableMakesMutexUnrecoverable) {
+    SharedStaticVectorBlocks pool(1 << 20);
+    int code = in_child([&] {
+        pool.lock();
+        // Умирает посреди изменения таблицы: счётчик записей заголовка обнулён.
+        std::uint64_t zero = 0;
+        std::memcpy(pool.base() + 40, &zero, sizeof(zero));
+        return 0;
+    });
+    ASSERT_EQ(code, 0);
+
+    EXPECT_FALSE(pool.consistent());
+    EXPECT_THROW(pool.lock(), std::runtime_error);
+    // Мьютекс не был восстановлен: отказ повторяется и в других процессах.
+    EXPECT_THROW(pool.lock(), std::runtime_error);
+    EXPECT_EQ(in_child([&] {
+                  try {
+                      pool.lock();
+                  } catch (const std::runtime_error&) {
+                      return 0;
+                  }
+                  return 3;
+              }),
+              0);
+    EXPECT_EQ(pool.owner_deaths(), 0u);
+}
+
+TEST(SharedStaticVectorBlocks, NamedSegmentIsAttachedBySecondOpen) {
+    std::string name = "/lab5_test_shared_" + std::to_string(::getpid());
+    SharedStaticVectorBlocks::unlink(name.c_str());
+    {
+        SharedStaticVectorBlocks first(name.c_str(), 1 << 20);
+        EXPECT_FALSE(first.restored());
+        auto q = OffsetQueue<Message>::at_root(first, 2);
+        q.push({42, 7});
+
+        // Размер при повторном открытии не важен: берётся из сегмента.
+        SharedStaticVectorBlocks second(name.c_str(), 0);
+        EXPECT_TRUE(second.restored());
+        EXPECT_EQ(second.region_size(), first.region_size());
+        auto q2 = OffsetQueue<Message>::at_root(second, 2);
+        ASSERT_EQ(q2.size(), 1u);
+        EXPECT_EQ(q2.front().id, 42u);
+        q2.push({43, 8});
+        EXPECT_EQ(q.back().id, 43u);
+    }
+    SharedStaticVectorBlocks::unlink(name.c_str());
+}
+
+TEST(SharedStaticVectorBlocks, FailedCreateUnlinksSegment) {
+    std::string name = "/lab5_test_shared_fail_" + std::to_string(::getpid());
+    SharedStaticVectorBlocks::unlink(name.c_str());
+    // Участок нулевой длины не вмещает таблицу: разметка не удаётся.
+    EXPECT_THROW(SharedStaticVectorBlocks(name.c_str(), 0), std::bad_alloc);
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0600);
+    EXPECT_LT(fd, 0);
+    if (fd >= 0) {
+        ::close(fd);
+        SharedStaticVectorBlocks::unlink(name.c_str());
+    }
+}
+
+#endif  // LAB5_HAS_SHARED_POOL
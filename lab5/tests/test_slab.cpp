@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+#include "slab_res.hpp"
+
+#include <set>
+#include <vector>
+
+TEST(SlabBlocks, SmallObjectsShareBackingPages) {
+    StaticVectorBlocks backing(1 << 20);
+    SlabBlocks slab(&backing, 16 * 1024);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 500; ++i) {
+        blocks.push_back(slab.allocate(24));
+    }
+    // 500 объектов по 32 байта — это одна страница, а не 500 записей Chunk.
+    EXPECT_EQ(slab.page_count(), 1u);
+    EXPECT_LE(backing.stats().chunks, 2u);
+
+    std::set<void*> unique(blocks.begin(), blocks.end());
+    EXPECT_EQ(unique.size(), blocks.size());
+
+    for (void* p : blocks) slab.deallocate(p, 24);
+}
+
+TEST(SlabBlocks, FreedSlotIsReusedFirst) {
+    StaticVectorBlocks backing(64 * 1024);
+    SlabBlocks slab(&backing, 4096);
+
+    void* a = slab.allocate(100);
+    void* b = slab.allocate(100);
+    slab.deallocate(a, 100);
+    EXPECT_EQ(slab.allocate(100), a);
+    EXPECT_NE(a, b);
+}
+
+TEST(SlabBlocks, LargeRequestsGoToBacking) {
+    StaticVectorBlocks backing(64 * 1024);
+    SlabBlocks slab(&backing, 4096);
+
+    void* big = slab.allocate(1000);
+    EXPECT_EQ(slab.page_count(), 0u);
+    EXPECT_EQ(backing.stats().used_bytes, 1000u);
+    slab.deallocate(big, 1000);
+    EXPECT_EQ(backing.stats().used_bytes, 0u);
+}
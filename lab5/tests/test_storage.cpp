@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "mem_res.hpp"
+#include "queue.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Ресурс по умолчанию, который отказывает на любой запрос, пока жив.
+struct NoHeap {
+    NoHeap() : prev(std::pmr::set_default_resource(std::pmr::null_memory_resource())) {}
+    ~NoHeap() { std::pmr::set_default_resource(prev); }
+    std::pmr::memory_resource* prev;
+};
+
+alignas(64) std::byte static_storage[256 * 1024];
+
+bool inside(const void* p, std::span<const std::byte> storage) {
+    auto* b = static_cast<const std::byte*>(p);
+    return b >= storage.data() && b < storage.data() + storage.size();
+}
+
+}  // namespace
+
+TEST(StaticVectorBlocksStorage, StackPoolWithoutHeap) {
+    alignas(16) std::byte storage[16 * 1024];
+    NoHeap guard;
+    {
+        StaticVectorBlocks pool{std::span<std::byte>(storage)};
+        PmrQueue<int> q(4, &pool);
+        for (int i = 0; i < 500; ++i) q.push(i);
+        for (int i = 0; i < 250; ++i) q.pop();
+        EXPECT_EQ(q.front(), 250);
+
+        std::pmr::string s("строка длиннее малого буфера std::string", &pool);
+        EXPECT_TRUE(inside(s.data(), storage));
+        EXPECT_EQ(std::string_view(s), "строка длиннее малого буфера std::string");
+    }
+}
+
+TEST(StaticVectorBlocksStorage, StaticPoolReservesMetadataAtTheEnd) {
+    StaticVectorBlocks::Options opts;
+    opts.placement = StaticVectorBlocks::Placement::BestFit;
+    opts.deferred_limit = 16;
+    NoHeap guard;
+    StaticVectorBlocks pool{std::span<std::byte>(static_storage), opts};
+
+    // Пул начинается с начала storage; служебный запас — 4 КиБ в конце.
+    StaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.free_bytes, sizeof(static_storage) - 4096);
+    void* first = pool.allocate(64);
+    EXPECT_EQ(first, static_storage);
+
+    void* blocks[40];
+    for (void*& p : blocks) p = pool.allocate(192);
+    for (void* p : blocks) pool.deallocate(p, 192);
+    pool.deallocate(first, 64);
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
+
+TEST(StaticVectorBlocksStorage, TableOutgrowsReserveIntoDefaultResource) {
+    alignas(16) static std::byte storage[64 * 1024];
+    StaticVectorBlocks pool{std::span<std::byte>(storage), StaticVectorBlocks::Placement::FirstFit};
+    std::size_t usable = pool.stats().free_bytes;
+    EXPECT_LT(usable, sizeof(storage));
+
+    // Тысяча блоков — таблица больше запаса в 4 КиБ и уходит в кучу.
+    std::vector<void*> blocks;
+    for (int i = 0; i < 1000; ++i) blocks.push_back(pool.allocate(32));
+    for (void* p : blocks) EXPECT_TRUE(inside(p, std::span<const std::byte>(storage, usable)));
+    for (std::size_t i = 0; i < blocks.size(); i += 2) pool.deallocate(blocks[i], 32);
+    for (std::size_t i = 1; i < blocks.size(); i += 2) pool.deallocate(blocks[i], 32);
+    EXPECT_EQ(pool.stats().chunks, 1u);
+    EXPECT_EQ(pool.stats().free_bytes, usable);
+}
+
+TEST(StaticVectorBlocksStorage, DeferredFreeDoesNotAllocate) {
+    alignas(16) static std::byte storage[256 * 1024];
+    StaticVectorBlocks::Options opts;
+    opts.deferred_limit = 64;
+    opts.metadata_reserve = 32 * 1024;
+    NoHeap guard;
+    StaticVectorBlocks pool{std::span<std::byte>(storage), opts};
+
+    // Списки отложенного слияния лежат в самих блоках, а буфер слияния зарезервирован
+    // заранее: сотни освобождений со слияниями не выходят за запас.
+    void* blocks[600];
+    for (int i = 0; i < 600; ++i) blocks[i] = pool.allocate(16 + 16 * (i % 20));
+    for (int i = 0; i < 600; ++i) pool.deallocate(blocks[i], 16 + 16 * (i % 20));
+    EXPECT_LE(pool.stats().deferred_blocks, 64u);
+    pool.coalesce();
+    EXPECT_EQ(pool.stats().chunks, 1u);
+}
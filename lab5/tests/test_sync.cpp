@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "queue.hpp"
+#include "sync_res.hpp"
+
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST(SyncStaticVectorBlocks, MagazinesAvoidTheLock) {
+    SyncStaticVectorBlocks pool(1 << 20);
+    void* p = pool.allocate(40);
+    pool.deallocate(p, 40);
+    std::size_t locks = pool.stats().lock_acquisitions;
+
+    // Блок одного класса снова и снова берётся из магазина потока.
+    for (int i = 0; i < 1000; ++i) {
+        void* q = pool.allocate(40);
+        EXPECT_EQ(q, p);
+        pool.deallocate(q, 40);
+    }
+    EXPECT_EQ(pool.stats().lock_acquisitions, locks);
+}
+
+TEST(SyncStaticVectorBlocks, ConcurrentQueuesReturnWholePool) {
+    SyncStaticVectorBlocks pool(4 << 20);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, t] {
+            PmrQueue<std::pmr::string> q(2, &pool);
+            for (int i = 0; i < 5000; ++i) {
+                q.emplace(std::to_string(t) + "_payload_" + std::to_string(i));
+                if (i % 3 == 0) q.pop();
+            }
+            while (!q.empty()) q.pop();
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    pool.flush();
+    SyncStaticVectorBlocks::Stats s = pool.stats();
+    EXPECT_EQ(s.pool.used_bytes, 0u);
+    EXPECT_EQ(s.pool.chunks, 1u);
+}
+
+TEST(SyncStaticVectorBlocks, FreedByAnotherThread) {
+    SyncStaticVectorBlocks pool(1 << 20);
+    std::mutex m;
+    std::vector<std::pmr::string> handoff;
+    constexpr int kCount = 3000;
+
+    std::thread producer([&] {
+        for (int i = 0; i < kCount; ++i) {
+            std::pmr::string s("message_long_enough_for_heap_" + std::to_string(i), &pool);
+            std::lock_guard<std::mutex> guard(m);
+            handoff.push_back(std::move(s));
+        }
+    });
+    std::thread consumer([&] {
+        int seen = 0;
+        while (seen < kCount) {
+            std::vector<std::pmr::string> batch;
+            {
+                std::lock_guard<std::mutex> guard(m);
+                batch.swap(handoff);
+            }
+            seen += static_cast<int>(batch.size());
+        }
+    });
+    producer.join();
+    consumer.join();
+
+    pool.flush();
+    EXPECT_EQ(pool.stats().pool.used_bytes, 0u);
+}
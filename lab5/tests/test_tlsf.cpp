@@ -0,0 +1,34 @@
+#include <gtest/gtest.h>
+
+#include "tlsf_res.hpp"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+TEST(TlsfBlocks, RandomChurnReturnsWholePool) {
+    const std::size_t pool_size = 1 << 20;
+    TlsfBlocks pool(pool_size);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> size_dist(1, 3000);
+
+    struct Live { void* p; std::size_t n; };
+    std::vector<Live> live;
+    for (int step = 0; step < 20000; ++step) {
+        if (!live.empty() && (rng() % 2 == 0 || live.size() > 200)) {
+            std::size_t i = rng() % live.size();
+            pool.deallocate(live[i].p, live[i].n);
+            live[i] = live.back();
+            live.pop_back();
+        } else {
+            std::size_t n = size_dist(rng);
+            void* p = pool.allocate(n);
+            std::memset(p, 0xAB, n);
+            live.push_back({p, n});
+        }
+    }
+    for (auto& l : live) pool.deallocate(l.p, l.n);
+
+    // После освобождения всего блоки должны слиться обратно в один.
+    EXPECT_NO_THROW(pool.deallocate(pool.allocate(pool_size * 3 / 4), pool_size * 3 / 4));
+}